@@ -0,0 +1,123 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <random>
+#include <algorithm>
+
+#include "dungeon.hpp"
+#include "util/grid.hpp"
+#include "util/bit_grid.hpp"
+#include "util/noise.hpp"
+
+namespace Bench
+{
+    /** Keep the optimizer from discarding a computed value. */
+    template <typename T>
+    inline void keep(const T &value)
+    {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    /** Call `fn` repeatedly for at least `min_seconds`, return the mean time per call in microseconds. */
+    template <typename F>
+    double measure(F &&fn, double min_seconds = 0.25)
+    {
+        using clock = std::chrono::steady_clock;
+
+        fn(); // warm up caches and scratch buffers
+
+        std::size_t iterations = 0;
+        auto start = clock::now();
+        std::chrono::duration<double> elapsed{};
+        do
+        {
+            fn();
+            ++iterations;
+            elapsed = clock::now() - start;
+        } while (elapsed.count() < min_seconds);
+
+        return elapsed.count() * 1e6 / iterations;
+    }
+
+    inline void header(const char *suite)
+    {
+        std::printf("\n== %s ==\n", suite);
+    }
+
+    inline void report(const std::string &name, double us, const std::string &note = "")
+    {
+        std::printf("  %-48s %12.2f us  %s\n", name.c_str(), us, note.c_str());
+    }
+
+    /** The generator parameters used by the game. */
+    inline Dungeon::Generator::Parameters default_params()
+    {
+        return {
+            .min_room_width = 6,
+            .max_room_width = 20,
+            .min_room_height = 4,
+            .max_room_height = 10,
+            .min_num_rooms = 6,
+            .max_num_rooms = 10,
+            .min_num_stairs = 2,
+            .max_num_stairs = 4,
+            .min_rock_hardness = 128,
+            .max_rock_hardness = 192,
+            .rock_hardness_smoothness = 5,
+            .rock_hardness_noise_amount = 50.f};
+    }
+
+    /** A standard 80x21 floor, generated with the same parameters as the game. */
+    inline Dungeon make_dungeon(int seed)
+    {
+        Dungeon d(80, 21);
+        Dungeon::Generator().generate_dungeon(d, default_params(), seed);
+        return d;
+    }
+
+    /**
+     * Synthetic hardness map of arbitrary size: perlin rock with open caves (0) where the
+     * noise is low and an immutable 255 border, like a generated floor.
+     */
+    inline Grid<unsigned char> make_hardness(std::size_t width, std::size_t height, int seed)
+    {
+        Grid<unsigned char> hardness(width, height, 0);
+        std::mt19937 rng(seed);
+        float off = std::uniform_real_distribution<float>(0.f, 256.f)(rng);
+
+        for (std::size_t y = 0; y < height; ++y)
+            for (std::size_t x = 0; x < width; ++x)
+            {
+                if (x == 0 || y == 0 || x == width - 1 || y == height - 1)
+                {
+                    hardness(x, y) = 255;
+                    continue;
+                }
+                float n = Noise::layered_perlin(x + off, y + off, 1.f, 0.08f, 4, 0.5f, 2.f);
+                hardness(x, y) = n < 0.f ? 0 : static_cast<unsigned char>(std::clamp(n * 400.f, 1.f, 254.f));
+            }
+        return hardness;
+    }
+
+    /** Non-zero cells of `grid` as a BitGrid, the layout the pathing and FOV code read. */
+    inline BitGrid to_bits(const Grid<unsigned char> &grid)
+    {
+        BitGrid bits(grid.width(), grid.height());
+        for (std::size_t y = 0; y < grid.height(); ++y)
+            for (std::size_t x = 0; x < grid.width(); ++x)
+                bits.set(x, y, grid(x, y));
+        return bits;
+    }
+} // namespace Bench
+
+// Benchmark suites, one per file in bench/
+void bench_pathing();
+void bench_generator();
+void bench_distance();
+void bench_fov();
+void bench_events();
+void bench_arena();
+void bench_entities();
+void bench_turns();
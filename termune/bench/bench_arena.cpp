@@ -0,0 +1,74 @@
+#include "bench.hpp"
+
+#include <memory>
+#include <vector>
+
+#include "util/arena.hpp"
+
+namespace
+{
+    // Stand-ins for a floor's entities: a vtable, some stats, and a few colors each
+    struct HeapEntity
+    {
+        virtual ~HeapEntity() = default;
+        int stats[16] = {};
+        std::vector<short> colors;
+    };
+
+    struct ArenaEntity
+    {
+        virtual ~ArenaEntity() = default;
+        int stats[16] = {};
+        const short *colors = nullptr;
+        std::size_t color_count = 0;
+    };
+
+    const std::vector<short> COLORS = {1, 3, 5};
+
+    void compare_floor(const std::string &label, std::size_t count)
+    {
+        std::vector<std::unique_ptr<HeapEntity>> heap;
+        double heap_us = Bench::measure([&]
+                                        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                heap.push_back(std::make_unique<HeapEntity>());
+                heap.back()->colors = COLORS;
+            }
+            Bench::keep(heap.back()->stats[0]);
+            heap.clear(); });
+
+        Arena arena;
+        Pool<ArenaEntity> pool(arena);
+        std::vector<ArenaEntity *> pooled;
+        double arena_us = Bench::measure([&]
+                                         {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                ArenaEntity *e = pool.create();
+                e->colors = arena.copy(COLORS.data(), COLORS.size());
+                e->color_count = COLORS.size();
+                pooled.push_back(e);
+            }
+            Bench::keep(pooled.back()->stats[0]);
+            for (ArenaEntity *e : pooled)
+                e->~ArenaEntity();
+            pooled.clear();
+            pool.reset();
+            arena.reset(); });
+
+        char note[64];
+        Bench::report(label + " make_unique and a color vector each", heap_us);
+        std::snprintf(note, sizeof(note), "x%.1f, %zu block(s)", heap_us / arena_us, arena.block_count());
+        Bench::report(label + " pool and arena, one reset", arena_us, note);
+    }
+} // namespace
+
+void bench_arena()
+{
+    Bench::header("arena: fill a floor with n entities, then change floors");
+
+    compare_floor("n=100", 100);
+    compare_floor("n=1k", 1000);
+    compare_floor("n=10k", 10000);
+}
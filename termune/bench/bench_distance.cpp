@@ -0,0 +1,67 @@
+#include "bench.hpp"
+
+#include "util/pathing.hpp"
+#include "util/distance_transform.hpp"
+
+namespace
+{
+    // Non-tunneling distance map both ways, checked against Dijkstra cell for cell
+    void compare_transforms(const std::string &label, const Grid<unsigned char> &blocked, std::size_t start)
+    {
+        const std::size_t w = blocked.width(), h = blocked.height();
+        const BitGrid bits = Bench::to_bits(blocked);
+
+        Pathing::BucketWorkspace ws(1);
+        DistanceTransform::Workspace dt;
+        Grid<Pathing::cost_t> dijkstra(w, h), bfs(w, h);
+
+        auto cost = [&](std::size_t, std::size_t to)
+        { return blocked.data()[to] ? Pathing::UNREACHABLE : Pathing::cost_t(1); };
+
+        double dijkstra_us = Bench::measure([&]
+                                            { Pathing::solve(ws, dijkstra, start, cost); });
+        double bfs_us = Bench::measure([&]
+                                       { DistanceTransform::bit_bfs(dt, bits, start, bfs); });
+
+        bool bfs_same = true;
+        for (std::size_t i = 0; i < w * h; ++i)
+            bfs_same &= bfs.data()[i] == dijkstra.data()[i];
+
+        char note[80];
+        Bench::report(label + " bucket Dijkstra", dijkstra_us);
+        std::snprintf(note, sizeof(note), "x%.2f, %zu levels%s", dijkstra_us / bfs_us, dt.levels,
+                      bfs_same ? "" : "  MISMATCH");
+        Bench::report(label + " bit BFS", bfs_us, note);
+    }
+
+    Grid<unsigned char> cave(std::size_t width, std::size_t height, std::size_t &start)
+    {
+        Grid<unsigned char> hardness = Bench::make_hardness(width, height, 1);
+        Grid<unsigned char> blocked(width, height);
+        for (std::size_t i = 0; i < width * height; ++i)
+            blocked.data()[i] = hardness.data()[i] != 0;
+
+        start = height / 2 * width + width / 2;
+        while (blocked.data()[start])
+            ++start;
+        return blocked;
+    }
+} // namespace
+
+void bench_distance()
+{
+    Bench::header("distance: non-tunneling map (unit costs)");
+
+    Dungeon d = Bench::make_dungeon(1);
+    Grid<unsigned char> floor_blocked(d.width, d.height);
+    for (std::size_t i = 0; i < std::size_t(d.width) * d.height; ++i)
+        floor_blocked.data()[i] = d.type_grid.data()[i] == Dungeon::CELL_ROCK;
+    compare_transforms("80x21 floor", floor_blocked, d.rooms[0].center_y * d.width + d.rooms[0].center_x);
+
+    for (std::size_t size : {256, 1000})
+    {
+        std::size_t start;
+        Grid<unsigned char> blocked = cave(size, size, start);
+        compare_transforms(std::to_string(size) + "x" + std::to_string(size) + " cave", blocked, start);
+    }
+}
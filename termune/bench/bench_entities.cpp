@@ -0,0 +1,167 @@
+#include "bench.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "entity_store.hpp"
+
+namespace
+{
+    using clock = std::chrono::steady_clock;
+
+    const short PALETTE[] = {1};
+
+    // Monsters and objects alternate, so both tables and the shared slots are exercised
+    Entity *add_one(EntityStore &store, std::size_t i)
+    {
+        mapsize_t x = i % 80, y = i % 21;
+        if (i % 2)
+            return store.add(Monster(x, y, 'm', PALETTE, 10, 10, Monster::Abilities::NONE, nullptr, Dice(0, 0, 0)));
+        return store.add(ObjectEntity(x, y, Object::TYPE_GOLD, PALETTE, false, nullptr,
+                                      0, 0, Dice(0, 0, 0), 0, 0, 0, 0, 0));
+    }
+
+    double since(clock::time_point start)
+    {
+        return std::chrono::duration<double, std::micro>(clock::now() - start).count();
+    }
+
+    /**
+     * Random adds, removes and deaths (swept by remove_inactive now and then), checking
+     * every so often that each live handle still resolves to its entity and that no stale
+     * handle resolves at all, though its slot has long been reused.
+     */
+    void check_handles(std::size_t operations)
+    {
+        std::mt19937 rng(3);
+        EntityStore store;
+        std::vector<std::pair<EntityHandle, Entity *>> live;
+        std::vector<EntityHandle> stale;
+        std::size_t wrong = 0;
+        auto start = clock::now();
+
+        auto retire = [&](std::size_t i)
+        {
+            stale.push_back(live[i].first);
+            live[i] = live.back();
+            live.pop_back();
+        };
+
+        for (std::size_t op = 0; op < operations; ++op)
+        {
+            switch (live.empty() ? 0 : rng() % 3)
+            {
+            case 0:
+            {
+                Entity *e = add_one(store, rng());
+                live.emplace_back(e->handle(), e);
+                break;
+            }
+            case 1:
+            {
+                std::size_t i = rng() % live.size();
+                store.remove(live[i].second);
+                retire(i);
+                break;
+            }
+            default:
+            {
+                Entity *e = live[rng() % live.size()].second;
+                e->active = false;
+                store.sync(e);
+                if (rng() % 20 == 0)
+                {
+                    store.remove_inactive([](Entity *) {});
+                    for (std::size_t i = 0; i < live.size();)
+                        if (!live[i].second->active)
+                            retire(i);
+                        else
+                            ++i;
+                }
+                break;
+            }
+            }
+
+            if (op % 1000 == 0)
+            {
+                for (const auto &[h, e] : live)
+                    wrong += store.get(h) != e;
+                for (const EntityHandle &h : stale)
+                    wrong += store.get(h) != nullptr;
+                wrong += store.size() != live.size();
+            }
+        }
+
+        char note[64];
+        std::snprintf(note, sizeof(note), "%zu stale, %zu wrong", stale.size(), wrong);
+        Bench::report(std::to_string(operations / 1000) + "k random operations", since(start), note);
+    }
+
+    // Removing shuffled entities one at a time, and half of them dying in the same turn,
+    // against a pointer vector searched and erased from the middle for each one
+    void compare_remove(const std::string &label, std::size_t count)
+    {
+        const int repeats = 5;
+        std::mt19937 rng(5);
+        double erase_us = 0, remove_us = 0, sweep_us = 0;
+
+        for (int r = 0; r < repeats; ++r)
+        {
+            std::vector<std::unique_ptr<Monster>> vec;
+            for (std::size_t i = 0; i < count; ++i)
+                vec.push_back(std::make_unique<Monster>(i % 80, i % 21, 'm', PALETTE, 10, 10,
+                                                        Monster::Abilities::NONE, nullptr, Dice(0, 0, 0)));
+            std::vector<Monster *> order;
+            for (const auto &m : vec)
+                order.push_back(m.get());
+            std::shuffle(order.begin(), order.end(), rng);
+
+            auto start = clock::now();
+            for (Monster *m : order)
+                vec.erase(std::find_if(vec.begin(), vec.end(), [&](const auto &p)
+                                       { return p.get() == m; }));
+            erase_us += since(start);
+
+            EntityStore store;
+            std::vector<Entity *> entities;
+            for (std::size_t i = 0; i < count; ++i)
+                entities.push_back(add_one(store, i));
+            std::shuffle(entities.begin(), entities.end(), rng);
+
+            start = clock::now();
+            for (Entity *e : entities)
+                store.remove(e);
+            remove_us += since(start);
+
+            for (std::size_t i = 0; i < count; ++i)
+                entities[i] = add_one(store, i);
+            for (std::size_t i = 0; i < count; i += 2)
+            {
+                entities[i]->active = false;
+                store.sync(entities[i]);
+            }
+
+            start = clock::now();
+            store.remove_inactive([](Entity *) {});
+            sweep_us += since(start);
+        }
+
+        Bench::report(label + " vector find and erase, each", erase_us / repeats / count);
+        char note[64];
+        std::snprintf(note, sizeof(note), "x%.1f", erase_us / remove_us);
+        Bench::report(label + " store remove, each", remove_us / repeats / count, note);
+        Bench::report(label + " half die, one remove_inactive", sweep_us / repeats);
+    }
+} // namespace
+
+void bench_entities()
+{
+    Bench::header("entities: stale handles after slot reuse");
+    check_handles(200000);
+
+    Bench::header("entities: removing n entities");
+    for (std::size_t n : {1000, 10000})
+        compare_remove("n=" + std::to_string(n / 1000) + "k", n);
+}
@@ -0,0 +1,221 @@
+#include "bench.hpp"
+
+#include <map>
+#include <queue>
+#include <utility>
+#include <functional>
+
+#include "util/event_queue.hpp"
+#include "util/timing_wheel.hpp"
+
+namespace
+{
+    // The callback queue EventQueue replaced, kept to compare against
+    namespace reference
+    {
+        class EventQueue
+        {
+        public:
+            using Callback = std::function<bool()>;
+
+            void add(Callback cb, tick_t delay) { queue_.push({std::move(cb), current_tick_ + delay}); }
+
+            bool process_one()
+            {
+                auto event = queue_.top();
+                queue_.pop();
+                current_tick_ = std::max(current_tick_, event.target_tick);
+                return event.callback();
+            }
+
+        private:
+            struct Event
+            {
+                Callback callback;
+                tick_t target_tick;
+                bool operator>(const Event &other) const { return target_tick > other.target_tick; }
+            };
+
+            std::priority_queue<Event, std::vector<Event>, std::greater<Event>> queue_;
+            tick_t current_tick_ = 0;
+        };
+    } // namespace reference
+
+    struct Actor
+    {
+        int delay;
+        EventQueue<Actor>::Handle turn = EventQueue<Actor>::NO_EVENT;
+        std::size_t turns = 0;
+    };
+
+    // Characters taking turns forever, each turn scheduling the next one like GameContext does
+    std::vector<Actor> make_actors(std::size_t count)
+    {
+        std::mt19937 rng(59);
+        std::vector<Actor> actors(count);
+        for (Actor &a : actors)
+            a.delay = 1000 / (5 + rng() % 16); // speeds 5..20
+        return actors;
+    }
+
+    // Per-event and cancel costs of one record queue, EventQueue or TimingWheel
+    template <typename Queue>
+    std::pair<double, double> time_records(std::vector<Actor> &actors)
+    {
+        Queue records;
+        for (Actor &a : actors)
+            a.turn = records.add(&a, 0, a.delay);
+        double turn_us = Bench::measure([&]
+                                        {
+            auto event = records.pop();
+            ++event.actor->turns;
+            event.actor->turn = records.add(event.actor, 0, event.actor->delay); });
+
+        // Actors die and are replaced at random, the rest keep their turns
+        std::mt19937 rng(61);
+        double cancel_us = Bench::measure([&]
+                                          {
+            Actor &a = actors[rng() % actors.size()];
+            records.cancel(a.turn);
+            a.turn = records.add(&a, 0, a.delay); });
+        return {turn_us, cancel_us};
+    }
+
+    void compare_turns(const std::string &label, std::size_t count)
+    {
+        std::vector<Actor> actors = make_actors(count);
+
+        reference::EventQueue callbacks;
+        std::function<void(Actor *)> schedule = [&](Actor *a)
+        {
+            callbacks.add([&, a]()
+                          {
+                ++a->turns;
+                schedule(a);
+                return false; }, a->delay);
+        };
+        for (Actor &a : actors)
+            schedule(&a);
+        double callback_us = Bench::measure([&]
+                                            { callbacks.process_one(); });
+
+        auto heap = time_records<EventQueue<Actor>>(actors);
+        auto wheel = time_records<TimingWheel<Actor>>(actors);
+
+        char note[64];
+        Bench::report(label + " std::function heap, per event", callback_us);
+        std::snprintf(note, sizeof(note), "x%.1f", callback_us / heap.first);
+        Bench::report(label + " indexed record heap, per event", heap.first, note);
+        std::snprintf(note, sizeof(note), "x%.1f", callback_us / wheel.first);
+        Bench::report(label + " timing wheel, per event", wheel.first, note);
+        Bench::report(label + " heap: cancel and re-add one", heap.second);
+        Bench::report(label + " wheel: cancel and re-add one", wheel.second);
+    }
+
+    // Random adds, cancels, reschedules and pops checked against a map keyed by (tick, order
+    // of scheduling), i.e. a stable sort by tick: every pop must return the same actor and tick.
+    // Some delays reach past 2^32 ticks, into the wheel's overflow list.
+    template <typename Queue>
+    void check_order(const std::string &label, std::size_t steps)
+    {
+        std::mt19937_64 rng(67);
+        auto delay = [&]() -> tick_t
+        {
+            switch (rng() % 4)
+            {
+            case 0:
+                return rng() % 300;
+            case 1:
+                return rng() % 70000;
+            case 2:
+                return rng() % (tick_t(1) << 33);
+            default:
+                return rng() % (tick_t(1) << 40);
+            }
+        };
+
+        using Key = std::pair<tick_t, std::size_t>;
+        std::map<Key, Actor *> expected;
+        std::map<typename Queue::Handle, Key> key_of;
+        std::size_t order = 0, pops = 0, differ = 0;
+
+        std::vector<Actor> actors(1000);
+        std::vector<typename Queue::Handle> handles(actors.size(), Queue::NO_EVENT);
+        Queue queue;
+
+        auto schedule = [&](std::size_t a, tick_t d)
+        {
+            Key key{queue.current_tick() + d, order++};
+            expected[key] = &actors[a];
+            key_of[handles[a]] = key;
+        };
+
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t step = 0; step < steps; ++step)
+        {
+            const std::size_t a = rng() % actors.size();
+            const unsigned op = rng() % 10;
+            if (op < 4)
+            {
+                if (!queue.scheduled(handles[a]))
+                {
+                    tick_t d = delay();
+                    handles[a] = queue.add(&actors[a], 0, d);
+                    schedule(a, d);
+                }
+            }
+            else if (op < 5)
+            {
+                if (queue.scheduled(handles[a]))
+                {
+                    expected.erase(key_of[handles[a]]);
+                    key_of.erase(handles[a]);
+                }
+                queue.cancel(handles[a]);
+            }
+            else if (op < 6)
+            {
+                if (queue.scheduled(handles[a]))
+                {
+                    tick_t d = delay();
+                    queue.reschedule(handles[a], d);
+                    expected.erase(key_of[handles[a]]);
+                    schedule(a, d);
+                }
+            }
+            else if (!queue.empty())
+            {
+                auto event = queue.pop();
+                auto next = expected.begin();
+                differ += event.actor != next->second || event.tick != next->first.first;
+                ++pops;
+
+                const std::size_t popped = next->second - actors.data();
+                key_of.erase(handles[popped]);
+                handles[popped] = Queue::NO_EVENT;
+                expected.erase(next);
+            }
+            differ += queue.size() != expected.size();
+        }
+        std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+
+        char note[64];
+        std::snprintf(note, sizeof(note), "%zu pops, %zu differ", pops, differ);
+        Bench::report(label, elapsed.count(), note);
+    }
+} // namespace
+
+void bench_events()
+{
+    Bench::header("events: character turns, n actors");
+
+    compare_turns("n=100", 100);
+    compare_turns("n=10k", 10000);
+    compare_turns("n=30k", 30000);
+    compare_turns("n=100k", 100000);
+
+    Bench::header("events: pop order against a stable sort by tick");
+
+    check_order<EventQueue<Actor>>("record heap, 200k random operations", 200000);
+    check_order<TimingWheel<Actor>>("timing wheel, 200k random operations", 200000);
+}
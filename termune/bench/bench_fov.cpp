@@ -0,0 +1,586 @@
+#include "bench.hpp"
+
+#include "util/shadowcast.hpp"
+#include "util/lighting.hpp"
+
+namespace
+{
+    // The recursive float version update_lightmap() replaced, kept to check against
+    namespace reference
+    {
+        constexpr float EPSILON = 0.0001f;
+
+        const int MULT[4][8] = {
+            {1, 0, 0, -1, -1, 0, 0, 1},
+            {0, 1, -1, 0, 0, -1, 1, 0},
+            {0, 1, 1, 0, 0, -1, -1, 0},
+            {1, 0, 0, 1, -1, 0, 0, -1}};
+
+        bool is_blocked(const Grid<unsigned char> &solid_map, int x, int y)
+        {
+            return static_cast<std::size_t>(x) >= solid_map.width() ||
+                   static_cast<std::size_t>(y) >= solid_map.height() ||
+                   solid_map(x, y);
+        }
+
+        void set_visible(ShadowCast::Lightmap &map, int x, int y)
+        {
+            if (static_cast<std::size_t>(x) < map.width() && static_cast<std::size_t>(y) < map.height())
+                map.set(x, y);
+        }
+
+        void cast_light(const Grid<unsigned char> &solid_map, ShadowCast::Lightmap &visible,
+                        int origin_x, int origin_y, int row, float start_slope, float end_slope,
+                        std::size_t radius, int xx, int xy, int yx, int yy)
+        {
+            if (start_slope < end_slope)
+                return;
+
+            int radius_sq = static_cast<int>(radius * radius);
+            for (int j = row; static_cast<std::size_t>(j) <= radius; ++j)
+            {
+                int dx = -j - 1;
+                int dy = -j;
+                bool blocked = false;
+                float new_start_slope = start_slope;
+
+                while (dx <= 0)
+                {
+                    ++dx;
+                    int X = origin_x + dx * xx + dy * xy;
+                    int Y = origin_y + dx * yx + dy * yy;
+
+                    float l_slope = (dx - 0.5f) / (dy + 0.5f);
+                    float r_slope = (dx + 0.5f) / (dy - 0.5f);
+
+                    if (start_slope + EPSILON < r_slope)
+                        continue;
+                    if (end_slope - EPSILON > l_slope)
+                        break;
+
+                    if (dx * dx + dy * dy < radius_sq && !is_blocked(solid_map, X, Y))
+                        set_visible(visible, X, Y);
+
+                    if (blocked)
+                    {
+                        if (is_blocked(solid_map, X, Y))
+                        {
+                            new_start_slope = r_slope;
+                            continue;
+                        }
+                        blocked = false;
+                        start_slope = new_start_slope;
+                    }
+                    else if (is_blocked(solid_map, X, Y))
+                    {
+                        blocked = true;
+                        cast_light(solid_map, visible, origin_x, origin_y, j + 1, start_slope, l_slope,
+                                   radius, xx, xy, yx, yy);
+                        new_start_slope = r_slope;
+                    }
+                }
+
+                if (blocked)
+                    break;
+            }
+        }
+
+        void update_lightmap(const Grid<unsigned char> &solid_map, ShadowCast::Lightmap &visible,
+                             std::size_t origin_x, std::size_t origin_y, std::size_t radius)
+        {
+            visible.fill(false);
+            set_visible(visible, static_cast<int>(origin_x), static_cast<int>(origin_y));
+            for (int oct = 0; oct < 8; ++oct)
+                cast_light(solid_map, visible, static_cast<int>(origin_x), static_cast<int>(origin_y),
+                           1, 1.0f, 0.0f, radius, MULT[0][oct], MULT[1][oct], MULT[2][oct], MULT[3][oct]);
+        }
+    } // namespace reference
+
+    // One update per origin, like the player walking around: the old version, the new one
+    // clearing the whole map, and the new one clearing only the last window (which at r <= 3
+    // also casts each window pattern once, see ShadowCast::cast_mask)
+    void compare_fov(const std::string &label, const Grid<unsigned char> &solid,
+                     std::size_t radius, std::size_t origins)
+    {
+        const std::size_t w = solid.width(), h = solid.height();
+        const BitGrid bits = Bench::to_bits(solid);
+
+        std::mt19937 rng(31);
+        std::vector<std::pair<std::size_t, std::size_t>> positions;
+        while (positions.size() < origins)
+        {
+            std::size_t x = rng() % w, y = rng() % h;
+            if (!solid(x, y))
+                positions.emplace_back(x, y);
+        }
+
+        ShadowCast::Lightmap expected(w, h, false), full(w, h, false), windowed(w, h, false);
+        ShadowCast::Workspace ws;
+
+        bool same = true;
+        for (auto [x, y] : positions)
+        {
+            reference::update_lightmap(solid, expected, x, y, radius);
+            ShadowCast::update_lightmap(bits, full, x, y, radius);
+            ShadowCast::update_lightmap(bits, windowed, x, y, radius, ws);
+            same &= expected == full && expected == windowed;
+        }
+
+        std::size_t i = 0;
+        auto next = [&]
+        { return positions[i++ % positions.size()]; };
+
+        double reference_us = Bench::measure([&]
+                                             { auto [x, y] = next(); reference::update_lightmap(solid, expected, x, y, radius); });
+        double full_us = Bench::measure([&]
+                                        { auto [x, y] = next(); ShadowCast::update_lightmap(bits, full, x, y, radius); });
+        double windowed_us = Bench::measure([&]
+                                            { auto [x, y] = next(); ShadowCast::update_lightmap(bits, windowed, x, y, radius, ws); });
+
+        char note[64];
+        Bench::report(label + " recursive, float slopes", reference_us, same ? "" : "MISMATCH");
+        std::snprintf(note, sizeof(note), "x%.1f", reference_us / full_us);
+        Bench::report(label + " explicit stack, whole map", full_us, note);
+        std::snprintf(note, sizeof(note), "x%.1f", reference_us / windowed_us);
+        Bench::report(label + " explicit stack, window only", windowed_us, note);
+    }
+
+    // The whole visibility path of a player move: deriving opacity, casting and storing the
+    // result, as GameContext did it at first, then per cell, and now in bit layers
+    void compare_visibility_update(const std::string &label, const Grid<unsigned char> &types, std::size_t moves)
+    {
+        struct Cell
+        {
+            Dungeon::cell_type_t last_seen;
+            bool visible;
+            bool explored;
+        };
+
+        const std::size_t w = types.width(), h = types.height();
+        Grid<Cell> cells(w, h, {Dungeon::CELL_ROCK, false, false});
+        Grid<unsigned char> solid(w, h);
+        for (std::size_t i = 0; i < w * h; ++i)
+            solid.data()[i] = types.data()[i] == 0;
+        const BitGrid opaque = Bench::to_bits(solid);
+
+        std::mt19937 rng(37);
+        std::vector<std::pair<std::size_t, std::size_t>> positions;
+        while (positions.size() < moves)
+        {
+            std::size_t x = rng() % w, y = rng() % h;
+            if (!solid(x, y))
+                positions.emplace_back(x, y);
+        }
+        std::size_t i = 0;
+
+        double rebuild_us = Bench::measure([&]
+                                           {
+            auto [px, py] = positions[i++ % positions.size()];
+            ShadowCast::Lightmap rebuilt(w, h);
+            for (std::size_t y = 0; y < h; ++y)
+                for (std::size_t x = 0; x < w; ++x)
+                    rebuilt.set(x, y, types(x, y) == 0);
+
+            auto lightmap = ShadowCast::solve_lightmap(rebuilt, px, py, 3);
+            for (std::size_t y = 0; y < h; ++y)
+                for (std::size_t x = 0; x < w; ++x)
+                {
+                    cells(x, y).visible = lightmap(x, y);
+                    if (lightmap(x, y))
+                        cells(x, y).last_seen = Dungeon::cell_type_t(types(x, y));
+                } });
+
+        ShadowCast::Workspace ws;
+        double cells_us = Bench::measure([&]
+                                         {
+            auto [px, py] = positions[i++ % positions.size()];
+            const ShadowCast::Window &last = ws.window;
+            for (std::size_t y = last.min_y; y < last.max_y; ++y)
+                for (std::size_t x = last.min_x; x < last.max_x; ++x)
+                    cells(x, y).visible = false;
+
+            ShadowCast::cast(opaque, px, py, 3, ws, [&](std::size_t x, std::size_t y)
+                             { cells(x, y) = {Dungeon::cell_type_t(types(x, y)), true, true}; }); });
+
+        BitGrid visible(w, h), explored(w, h);
+        Grid<Dungeon::cell_type_t> remembered(w, h, Dungeon::CELL_ROCK);
+        ShadowCast::Workspace bit_ws;
+        double layers_us = Bench::measure([&]
+                                          {
+            auto [px, py] = positions[i++ % positions.size()];
+            const ShadowCast::Window &last = bit_ws.window;
+            for (std::size_t y = last.min_y; y < last.max_y; ++y)
+                visible.fill_span(y, last.min_x, last.max_x, false);
+
+            ShadowCast::cast(opaque, px, py, 3, bit_ws, [&](std::size_t x, std::size_t y)
+                             {
+                visible.set(x, y);
+                remembered(x, y) = Dungeon::cell_type_t(types(x, y));
+                explored.set(x, y); }); });
+
+        char note[64];
+        Bench::report(label + " rebuild opacity, new lightmap, copy", rebuild_us);
+        std::snprintf(note, sizeof(note), "x%.1f, %zu B/cell", rebuild_us / cells_us, sizeof(Cell));
+        Bench::report(label + " cached opacity, cast into cells", cells_us, note);
+        std::snprintf(note, sizeof(note), "x%.1f, %.2f B/cell", rebuild_us / layers_us,
+                      (2.0 * visible.words_per_row() * 8 * h + w * h) / double(w * h));
+        Bench::report(label + " cached opacity, cast into bit layers", layers_us, note);
+    }
+
+    // Which of `count` monsters see the player: a symmetric cast from every monster looking for
+    // the player's cell, or one from the player and a lookup per monster. Both must agree.
+    void compare_monster_sight(const std::string &label, const Grid<unsigned char> &solid,
+                               std::size_t radius, std::size_t count)
+    {
+        const std::size_t w = solid.width(), h = solid.height();
+        const BitGrid opaque = Bench::to_bits(solid);
+
+        // Monsters crowd around the player, so many of them are close enough to matter
+        std::mt19937 rng(43);
+        std::size_t px, py;
+        do
+        {
+            px = rng() % w;
+            py = rng() % h;
+        } while (solid(px, py));
+
+        const std::size_t spread = std::max<std::size_t>(2 * radius, 10);
+        std::vector<std::pair<std::size_t, std::size_t>> monsters;
+        while (monsters.size() < count)
+        {
+            std::size_t x = px + rng() % (2 * spread + 1) - spread, y = py + rng() % (2 * spread + 1) - spread;
+            if (x < w && y < h && !solid(x, y))
+                monsters.emplace_back(x, y);
+        }
+
+        std::vector<char> each(count), batched(count);
+        ShadowCast::Workspace ws;
+        double each_us = Bench::measure([&]
+                                        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                bool seen = false;
+                ShadowCast::cast_symmetric(opaque, monsters[i].first, monsters[i].second, radius, ws,
+                                           [&](std::size_t x, std::size_t y)
+                                           { seen |= x == px && y == py; });
+                each[i] = seen;
+            } });
+
+        BitGrid lit(w, h);
+        ShadowCast::Workspace lit_ws;
+        double batched_us = Bench::measure([&]
+                                           {
+            for (std::size_t y = lit_ws.window.min_y; y < lit_ws.window.max_y; ++y)
+                lit.fill_span(y, lit_ws.window.min_x, lit_ws.window.max_x, false);
+            ShadowCast::cast_symmetric(opaque, px, py, radius, lit_ws, [&](std::size_t x, std::size_t y)
+                                       { lit.set(x, y); });
+            for (std::size_t i = 0; i < count; ++i)
+                batched[i] = lit(monsters[i].first, monsters[i].second); });
+
+        std::size_t seeing = 0, disagree = 0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            seeing += batched[i];
+            disagree += each[i] != batched[i];
+        }
+
+        char note[64];
+        std::snprintf(note, sizeof(note), "%zu see", seeing);
+        Bench::report(label + " cast per monster", each_us, note);
+        std::snprintf(note, sizeof(note), "x%.1f, %zu differ", each_us / batched_us, disagree);
+        Bench::report(label + " one cast, lookups", batched_us, note);
+    }
+
+    // The per-cell table against casting: building it, one player move, and a cell opened
+    // next to the player (its 7x7 origins recomputed on the next lookups)
+    void compare_table(const std::string &label, const Grid<unsigned char> &solid, std::size_t moves)
+    {
+        const std::size_t w = solid.width(), h = solid.height(), radius = ShadowCast::Table::MAX_RADIUS;
+        BitGrid opaque = Bench::to_bits(solid);
+
+        ShadowCast::Table table(w, h, radius);
+        double build_us = Bench::measure([&]
+                                         {
+            table.reset(w, h, radius);
+            table.build(opaque); }, 0.05);
+
+        std::mt19937 rng(47);
+        std::vector<std::pair<std::size_t, std::size_t>> positions;
+        while (positions.size() < moves)
+        {
+            std::size_t x = rng() % w, y = rng() % h;
+            if (!solid(x, y))
+                positions.emplace_back(x, y);
+        }
+
+        BitGrid cast_lit(w, h), table_lit(w, h);
+        ShadowCast::Workspace cast_ws, table_ws;
+        auto lookup = [&](std::size_t x, std::size_t y)
+        {
+            const ShadowCast::Window &last = table_ws.window;
+            for (std::size_t row = last.min_y; row < last.max_y; ++row)
+                table_lit.fill_span(row, last.min_x, last.max_x, false);
+            table.cast(opaque, x, y, table_ws, [&](std::size_t vx, std::size_t vy)
+                       { table_lit.set(vx, vy); });
+        };
+
+        bool same = true;
+        for (auto [x, y] : positions)
+        {
+            ShadowCast::update_lightmap(opaque, cast_lit, x, y, radius, cast_ws);
+            lookup(x, y);
+            same &= cast_lit == table_lit;
+        }
+
+        std::size_t i = 0;
+        double cast_us = Bench::measure([&]
+                                        { auto [x, y] = positions[i++ % positions.size()];
+                                          ShadowCast::update_lightmap(opaque, cast_lit, x, y, radius, cast_ws); });
+        double lookup_us = Bench::measure([&]
+                                          { auto [x, y] = positions[i++ % positions.size()]; lookup(x, y); });
+
+        // Flip a rock cell next to each position and look again from there
+        double changed_us = Bench::measure([&]
+                                           {
+            auto [x, y] = positions[i++ % positions.size()];
+            std::size_t nx = std::min(x + 1, w - 1);
+            opaque.set(nx, y, !opaque(nx, y));
+            table.cell_changed(nx, y);
+            lookup(x, y); });
+
+        // Every origin near a flipped cell was recomputed, so the table must still match
+        for (auto [x, y] : positions)
+        {
+            ShadowCast::update_lightmap(opaque, cast_lit, x, y, radius, cast_ws);
+            lookup(x, y);
+            same &= cast_lit == table_lit;
+        }
+
+        char note[64];
+        std::snprintf(note, sizeof(note), "%zu KB", w * h * sizeof(ShadowCast::Table::mask_t) / 1024);
+        Bench::report(label + " build table, every cell", build_us, note);
+        Bench::report(label + " cast per move", cast_us, same ? "" : "MISMATCH");
+        std::snprintf(note, sizeof(note), "x%.1f", cast_us / lookup_us);
+        Bench::report(label + " table lookup per move", lookup_us, note);
+        std::snprintf(note, sizeof(note), "x%.1f", cast_us / changed_us);
+        Bench::report(label + " cell opened, then lookup", changed_us, note);
+    }
+
+    // A turn with `count` lights of which `moving` move a step, and one rock cell opened:
+    // every source recast, or only the ones that moved or can reach the opened cell
+    void compare_lighting(const std::string &label, const Grid<unsigned char> &solid,
+                          std::size_t count, std::size_t moving)
+    {
+        const std::size_t w = solid.width(), h = solid.height();
+        BitGrid opaque = Bench::to_bits(solid);
+
+        std::mt19937 rng(53);
+        auto open_cell = [&]
+        {
+            std::size_t x, y;
+            do
+            {
+                x = rng() % w;
+                y = rng() % h;
+            } while (opaque(x, y));
+            return std::make_pair(x, y);
+        };
+
+        std::vector<Lighting::Source> sources;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            auto [x, y] = open_cell();
+            sources.push_back({x, y, 2 + rng() % 5, Lighting::level_t(50 + rng() % 150)});
+        }
+
+        auto step = [&](Lighting::LightMap *incremental)
+        {
+            for (std::size_t i = 0; i < moving; ++i)
+            {
+                Lighting::Source &s = sources[rng() % count];
+                std::size_t nx = s.x + rng() % 3 - 1, ny = s.y + rng() % 3 - 1;
+                if (nx < w && ny < h && !opaque(nx, ny))
+                {
+                    s.x = nx;
+                    s.y = ny;
+                }
+                if (incremental)
+                    incremental->set_source(&s, s);
+            }
+
+            // Toggle a cell near some light, so it matters
+            const Lighting::Source &near = sources[rng() % count];
+            std::size_t cx = std::min(near.x + 2, w - 1), cy = near.y;
+            opaque.set(cx, cy, !opaque(cx, cy));
+            if (incremental)
+                incremental->cell_changed(cx, cy);
+        };
+
+        Lighting::LightMap full, incremental;
+        incremental.reset(w, h);
+        for (auto &s : sources)
+            incremental.set_source(&s, s);
+        incremental.update(opaque);
+
+        double full_us = Bench::measure([&]
+                                        {
+            step(nullptr);
+            full.reset(w, h);
+            for (auto &s : sources)
+                full.set_source(&s, s);
+            full.update(opaque); });
+
+        // Bring the incremental map up to the same sources and terrain, then time its turns
+        for (auto &s : sources)
+            incremental.set_source(&s, s);
+        for (std::size_t y = 0; y < h; ++y)
+            for (std::size_t x = 0; x < w; ++x)
+                if (opaque(x, y) != bool(solid(x, y)))
+                    incremental.cell_changed(x, y);
+        incremental.update(opaque);
+
+        const std::size_t casts_before = incremental.casts();
+        std::size_t turns = 0;
+        double incremental_us = Bench::measure([&]
+                                               {
+            step(&incremental);
+            incremental.update(opaque);
+            ++turns; });
+
+        full.reset(w, h);
+        for (auto &s : sources)
+            full.set_source(&s, s);
+        full.update(opaque);
+        bool same = true;
+        for (std::size_t y = 0; y < h; ++y)
+            for (std::size_t x = 0; x < w; ++x)
+                same &= full.at(x, y) == incremental.at(x, y);
+
+        char note[64];
+        Bench::report(label + " recast every source", full_us, same ? "" : "MISMATCH");
+        std::snprintf(note, sizeof(note), "x%.1f, %.1f casts/turn", full_us / incremental_us,
+                      double(incremental.casts() - casts_before) / (turns + 1));
+        Bench::report(label + " recast dirty sources", incremental_us, note);
+    }
+
+    // Explored cells next to unexplored ones: a 3x3 scan per cell, or one dilation of the
+    // unexplored layer masked with the explored one
+    void compare_frontier(const std::string &label, const BitGrid &explored)
+    {
+        const std::size_t w = explored.width(), h = explored.height();
+        BitGrid scanned(w, h), dilated(w, h), unexplored(w, h, true);
+        unexplored.andnot(explored);
+
+        double scan_us = Bench::measure([&]
+                                        {
+            for (std::size_t y = 0; y < h; ++y)
+                for (std::size_t x = 0; x < w; ++x)
+                {
+                    bool edge = false;
+                    for (std::size_t ny = y ? y - 1 : 0; ny <= std::min(h - 1, y + 1); ++ny)
+                        for (std::size_t nx = x ? x - 1 : 0; nx <= std::min(w - 1, x + 1); ++nx)
+                            edge |= !explored(nx, ny);
+                    scanned.set(x, y, explored(x, y) && edge);
+                } });
+        double dilate_us = Bench::measure([&]
+                                          {
+            unexplored.dilate(dilated);
+            dilated &= explored; });
+
+        char note[64];
+        Bench::report(label + " 3x3 scan per cell", scan_us, scanned == dilated ? "" : "MISMATCH");
+        std::snprintf(note, sizeof(note), "x%.1f, %zu cells", scan_us / dilate_us, dilated.count());
+        Bench::report(label + " dilate unexplored, and explored", dilate_us, note);
+    }
+} // namespace
+
+void bench_fov()
+{
+    Bench::header("fov: shadowcast update per player move");
+
+    Dungeon d = Bench::make_dungeon(1);
+    Grid<unsigned char> floor_solid(d.width, d.height);
+    for (std::size_t i = 0; i < std::size_t(d.width) * d.height; ++i)
+        floor_solid.data()[i] = d.type_grid.data()[i] == Dungeon::CELL_ROCK;
+
+    compare_fov("80x21 r=3", floor_solid, 3, 500);
+    compare_fov("80x21 r=10", floor_solid, 10, 500);
+
+    Grid<unsigned char> cave = Bench::make_hardness(1000, 1000, 1);
+    for (std::size_t i = 0; i < 1000 * 1000; ++i)
+        cave.data()[i] = cave.data()[i] != 0;
+    compare_fov("1000x1000 r=3", cave, 3, 200);
+    compare_fov("1000x1000 r=20", cave, 20, 200);
+
+    // Every radius the old epsilon keeps exact, from every open cell of a few floors
+    bool same = true;
+    for (int seed = 1; seed <= 5; ++seed)
+    {
+        Dungeon floor = Bench::make_dungeon(seed);
+        Grid<unsigned char> solid(floor.width, floor.height);
+        for (std::size_t i = 0; i < std::size_t(floor.width) * floor.height; ++i)
+            solid.data()[i] = floor.type_grid.data()[i] == Dungeon::CELL_ROCK;
+        const BitGrid bits = Bench::to_bits(solid);
+
+        ShadowCast::Lightmap expected(floor.width, floor.height), windowed(floor.width, floor.height, false);
+        ShadowCast::Workspace ws;
+        for (std::size_t radius = 0; radius < 50; ++radius)
+            for (std::size_t y = 0; y < floor.height; ++y)
+                for (std::size_t x = 0; x < floor.width; ++x)
+                {
+                    if (solid(x, y))
+                        continue;
+                    reference::update_lightmap(solid, expected, x, y, radius);
+                    ShadowCast::update_lightmap(bits, windowed, x, y, radius, ws);
+                    same &= expected == windowed;
+                }
+    }
+    Bench::report("80x21 every open cell, r=0..49", 0, same ? "identical" : "MISMATCH");
+
+    Bench::header("fov: visibility update per player move, r=3");
+
+    Grid<unsigned char> floor_types(d.width, d.height); // Dungeon::cell_type_t, 0 is rock
+    for (std::size_t i = 0; i < std::size_t(d.width) * d.height; ++i)
+        floor_types.data()[i] = d.type_grid.data()[i];
+    compare_visibility_update("80x21", floor_types, 500);
+
+    Grid<unsigned char> cave_types(1000, 1000);
+    for (std::size_t i = 0; i < 1000 * 1000; ++i)
+        cave_types.data()[i] = cave.data()[i] ? Dungeon::CELL_ROCK : Dungeon::CELL_CORRIDOR;
+    compare_visibility_update("1000x1000", cave_types, 200);
+
+    Bench::header("fov: which of n monsters see the player");
+
+    compare_monster_sight("80x21 r=3 n=10", floor_solid, 3, 10);
+    compare_monster_sight("1000x1000 r=3 n=100", cave, 3, 100);
+    compare_monster_sight("1000x1000 r=10 n=100", cave, 10, 100);
+    compare_monster_sight("1000x1000 r=10 n=1000", cave, 10, 1000);
+
+    Bench::header("fov: per-cell visibility table, r=3");
+
+    compare_table("80x21", floor_solid, 500);
+    compare_table("1000x1000", cave, 200);
+
+    Bench::header("fov: lights per turn, m of n moving, one cell opened");
+
+    compare_lighting("80x21 n=10 m=3", floor_solid, 10, 3);
+    compare_lighting("1000x1000 n=50 m=5", cave, 50, 5);
+    compare_lighting("1000x1000 n=500 m=5", cave, 500, 5);
+
+    Bench::header("fov: explore frontier from bit layers");
+
+    // Explored: everything lit from a few hundred random open cells of the cave
+    BitGrid explored(1000, 1000);
+    ShadowCast::Lightmap lit(1000, 1000);
+    std::mt19937 rng(41);
+    const BitGrid cave_bits = Bench::to_bits(cave);
+    for (int n = 0; n < 300; ++n)
+    {
+        std::size_t x = rng() % 1000, y = rng() % 1000;
+        if (cave(x, y))
+            continue;
+        ShadowCast::update_lightmap(cave_bits, lit, x, y, 20);
+        explored |= lit;
+    }
+    compare_frontier("1000x1000", explored);
+}
@@ -0,0 +1,107 @@
+#include "bench.hpp"
+
+#include <cstdlib>
+
+#include "util/pathing.hpp"
+
+namespace
+{
+    // One room-to-room corridor query, costed the way the generator routes them
+    struct Route
+    {
+        const unsigned char *hardness;
+        unsigned char min_step;
+        std::size_t start, goal;
+    };
+
+    Pathing::cost_t route(Pathing::Workspace &ws, Grid<Pathing::cost_t> &dist, const Route &r, bool astar)
+    {
+        auto step = [&](std::size_t, std::size_t to)
+        { return Pathing::cost_t(std::max(r.hardness[to], r.min_step)); };
+
+        if (astar)
+        {
+            Pathing::solve_astar<Pathing::Connectivity::FOUR>(
+                ws, dist, r.start, r.goal, step, [&](std::size_t idx)
+                {
+                    int dx = int(idx % 80) - int(r.goal % 80);
+                    int dy = int(idx / 80) - int(r.goal / 80);
+                    return Pathing::cost_t((std::abs(dx) + std::abs(dy)) * r.min_step); });
+        }
+        else
+        {
+            Pathing::solve<Pathing::Connectivity::FOUR>(ws, dist, r.start, step, [&](std::size_t idx)
+                                                        { return idx == r.goal; });
+        }
+        return dist.data()[r.goal];
+    }
+} // namespace
+
+void bench_generator()
+{
+    Bench::header("generator: corridor routing");
+
+    Dungeon::Generator generator;
+    Dungeon::Generator::Stats stats;
+    int seed = 1;
+    double gen_us = Bench::measure([&]
+                                   {
+        Dungeon d(80, 21);
+        generator.generate_dungeon(d, Bench::default_params(), seed++, &stats);
+        Bench::keep(d.rooms.size()); });
+
+    char note[80];
+    std::snprintf(note, sizeof(note), "%.1f expanded per corridor",
+                  double(stats.corridor_expansions) / stats.corridor_searches);
+    Bench::report("generate_dungeon (A* corridors)", gen_us, note);
+
+    // Route every room pair of a batch of finished floors with both searches
+    std::vector<Dungeon> floors;
+    std::vector<Route> routes;
+    for (int i = 0; i < 200; ++i)
+        floors.push_back(Bench::make_dungeon(1000 + i));
+
+    for (const Dungeon &d : floors)
+    {
+        unsigned char min_step = 255;
+        for (std::size_t i = 0; i < 80 * 21; ++i)
+            if (d.type_grid.data()[i] == Dungeon::CELL_ROCK)
+                min_step = std::min(min_step, d.hardness_grid.data()[i]);
+
+        for (std::size_t r = 0; r < d.rooms.size(); ++r)
+        {
+            const auto &a = d.rooms[r];
+            const auto &b = d.rooms[(r + 1) % d.rooms.size()];
+            routes.push_back({d.hardness_grid.data(), min_step,
+                              std::size_t(a.center_y) * 80 + a.center_x,
+                              std::size_t(b.center_y) * 80 + b.center_x});
+        }
+    }
+
+    Pathing::Workspace ws;
+    Grid<Pathing::cost_t> dist(80, 21);
+
+    std::size_t expanded[2] = {0, 0};
+    bool same_cost = true;
+    for (const Route &r : routes)
+    {
+        Pathing::cost_t dijkstra_cost = route(ws, dist, r, false);
+        expanded[0] += ws.expanded;
+        same_cost &= route(ws, dist, r, true) == dijkstra_cost;
+        expanded[1] += ws.expanded;
+    }
+
+    double us[2];
+    for (int astar = 0; astar < 2; ++astar)
+        us[astar] = Bench::measure([&]
+                                   {
+            for (const Route &r : routes)
+                Bench::keep(route(ws, dist, r, astar)); });
+
+    std::string label = "route " + std::to_string(routes.size()) + " corridors, ";
+    std::snprintf(note, sizeof(note), "%.1f expanded per corridor", double(expanded[0]) / routes.size());
+    Bench::report(label + "Dijkstra", us[0], note);
+    std::snprintf(note, sizeof(note), "x%.2f, %.1f expanded per corridor%s", us[0] / us[1],
+                  double(expanded[1]) / routes.size(), same_cost ? "" : "  COST MISMATCH");
+    Bench::report(label + "A*", us[1], note);
+}
@@ -0,0 +1,39 @@
+#include <cstring>
+#include <cstdio>
+
+#include "bench.hpp"
+#include "util/noise.hpp"
+
+struct Suite
+{
+    const char *name;
+    void (*run)();
+};
+
+static const Suite SUITES[] = {
+    {"pathing", bench_pathing},
+    {"generator", bench_generator},
+    {"distance", bench_distance},
+    {"fov", bench_fov},
+    {"events", bench_events},
+    {"arena", bench_arena},
+    {"entities", bench_entities},
+    {"turns", bench_turns},
+};
+
+int main(int argc, char const *argv[])
+{
+    Noise::generate_permutation(327);
+
+    // Run every suite, or only the ones named on the command line
+    for (const Suite &suite : SUITES)
+    {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; ++i)
+            selected |= std::strcmp(argv[i], suite.name) == 0;
+
+        if (selected)
+            suite.run();
+    }
+    return 0;
+}
@@ -0,0 +1,398 @@
+#include "bench.hpp"
+
+#include "util/pathing.hpp"
+#include "util/jps.hpp"
+#include "util/flow_field.hpp"
+#include "util/goal_map.hpp"
+#include "distance_maps.hpp"
+
+namespace
+{
+    // Same step costs as GameContext's distance maps
+    struct TunnelingCost
+    {
+        const unsigned char *hardness;
+        Pathing::cost_t operator()(std::size_t, std::size_t to) const
+        {
+            return hardness[to] < 255 ? Pathing::cost_t(1 + hardness[to] / 85) : Pathing::UNREACHABLE;
+        }
+    };
+
+    struct OpenCost
+    {
+        const unsigned char *hardness;
+        Pathing::cost_t operator()(std::size_t, std::size_t to) const
+        {
+            return hardness[to] == 0 ? Pathing::cost_t(1) : Pathing::UNREACHABLE;
+        }
+    };
+
+    template <typename Cost>
+    void compare_frontiers(const std::string &label, const Grid<unsigned char> &hardness,
+                           std::size_t start, Cost cost, Pathing::cost_t max_step)
+    {
+        Pathing::Workspace heap_ws;
+        Pathing::BucketWorkspace bucket_ws(max_step);
+        Grid<Pathing::cost_t> heap_dist(hardness.width(), hardness.height());
+        Grid<Pathing::cost_t> bucket_dist(hardness.width(), hardness.height());
+
+        double heap_us = Bench::measure([&]
+                                        { Pathing::solve(heap_ws, heap_dist, start, cost); });
+        double bucket_us = Bench::measure([&]
+                                          { Pathing::solve(bucket_ws, bucket_dist, start, cost); });
+
+        bool same = std::equal(heap_dist.data(), heap_dist.data() + hardness.width() * hardness.height(),
+                               bucket_dist.data());
+
+        char note[64];
+        std::snprintf(note, sizeof(note), "%zu expanded", heap_ws.expanded);
+        Bench::report(label + " heap", heap_us, note);
+        std::snprintf(note, sizeof(note), "x%.2f%s", heap_us / bucket_us, same ? "" : "  MISMATCH");
+        Bench::report(label + " bucket", bucket_us, note);
+    }
+} // namespace
+
+namespace
+{
+    // Random open start/goal pairs on a blocked map, answered by Dijkstra and by JPS
+    void compare_point_queries(const std::string &label, const Grid<unsigned char> &blocked, int queries)
+    {
+        std::mt19937 rng(11);
+        std::vector<std::pair<std::size_t, std::size_t>> pairs;
+        const std::size_t size = blocked.width() * blocked.height();
+        while (pairs.size() < static_cast<std::size_t>(queries))
+        {
+            std::size_t a = rng() % size, b = rng() % size;
+            if (!blocked.data()[a] && !blocked.data()[b])
+                pairs.emplace_back(a, b);
+        }
+
+        const BitGrid bits = Bench::to_bits(blocked);
+        Pathing::BucketWorkspace ws(1);
+        Grid<Pathing::cost_t> dist(blocked.width(), blocked.height());
+        Pathing::JumpPointSearch jps;
+        std::vector<std::size_t> path;
+
+        auto dijkstra = [&](std::size_t a, std::size_t b)
+        {
+            Pathing::solve(
+                ws, dist, a, [&](std::size_t, std::size_t to)
+                { return blocked.data()[to] ? Pathing::UNREACHABLE : Pathing::cost_t(1); },
+                [b](std::size_t idx)
+                { return idx == b; });
+            return dist.data()[b];
+        };
+
+        std::size_t expanded[2] = {0, 0};
+        bool same = true;
+        for (auto [a, b] : pairs)
+        {
+            Pathing::cost_t expected = dijkstra(a, b);
+            expanded[0] += ws.expanded;
+            bool found = jps.find_path(bits, a, b, path);
+            expanded[1] += jps.expanded();
+            same &= found ? path.size() - 1 == expected : expected == Pathing::UNREACHABLE;
+        }
+
+        double dijkstra_us = Bench::measure([&]
+                                            { for (auto [a, b] : pairs) Bench::keep(dijkstra(a, b)); });
+        double jps_us = Bench::measure([&]
+                                       { for (auto [a, b] : pairs) Bench::keep(jps.find_path(bits, a, b, path)); });
+
+        char note[80];
+        std::snprintf(note, sizeof(note), "%.0f expanded per query", double(expanded[0]) / queries);
+        Bench::report(label + " Dijkstra", dijkstra_us / queries, note);
+        std::snprintf(note, sizeof(note), "x%.1f, %.0f expanded per query%s", dijkstra_us / jps_us,
+                      double(expanded[1]) / queries, same ? "" : "  MISMATCH");
+        Bench::report(label + " JPS", jps_us / queries, note);
+    }
+} // namespace
+
+namespace
+{
+    // Many monsters each picking their next move: scanning the 8 neighbors of a cost map
+    // (what Monster::get_desired_move used to do) against one flow field lookup
+    void compare_flow(const std::string &label, const Grid<Pathing::cost_t> &dist, std::size_t monsters)
+    {
+        const std::size_t w = dist.width(), h = dist.height();
+        std::mt19937 rng(17);
+        std::vector<std::pair<std::size_t, std::size_t>> positions;
+        while (positions.size() < monsters)
+        {
+            std::size_t x = rng() % w, y = rng() % h;
+            if (dist(x, y) != Pathing::UNREACHABLE)
+                positions.emplace_back(x, y);
+        }
+
+        using N = Pathing::Neighborhood<Pathing::Connectivity::EIGHT>;
+        double scan_us = Bench::measure([&]
+                                        {
+            for (auto [x, y] : positions)
+            {
+                int best_dx = 0, best_dy = 0;
+                Pathing::cost_t best = dist(x, y);
+                for (int i = 0; i < N::count; ++i)
+                {
+                    std::size_t nx = x + N::dx[i], ny = y + N::dy[i];
+                    if (nx < w && ny < h && dist(nx, ny) < best)
+                    {
+                        best = dist(nx, ny);
+                        best_dx = N::dx[i];
+                        best_dy = N::dy[i];
+                    }
+                }
+                Bench::keep(best_dx + best_dy);
+            } });
+
+        // One move per monster right after the map changed, like a turn in the game
+        Pathing::FlowField flow;
+        auto lookups = [&]
+        {
+            for (auto [x, y] : positions)
+            {
+                int dx = 0, dy = 0;
+                flow.step(x, y, dx, dy);
+                Bench::keep(dx + dy);
+            }
+        };
+        double lazy_us = Bench::measure([&]
+                                        { flow.reset(dist); lookups(); });
+        double eager_us = Bench::measure([&]
+                                         { flow.reset(dist); flow.resolve_all(); lookups(); });
+        double cached_us = Bench::measure(lookups); // map unchanged since the last turn
+
+        char note[96];
+        std::snprintf(note, sizeof(note), "%zu monsters, %zu bytes of costs", monsters, w * h * sizeof(Pathing::cost_t));
+        Bench::report(label + " neighbor scan", scan_us, note);
+        std::snprintf(note, sizeof(note), "x%.1f, %zu bytes", scan_us / lazy_us, flow.bytes());
+        Bench::report(label + " flow field, resolved on lookup", lazy_us, note);
+        std::snprintf(note, sizeof(note), "x%.1f", scan_us / eager_us);
+        Bench::report(label + " flow field, resolve_all first", eager_us, note);
+        std::snprintf(note, sizeof(note), "x%.1f", scan_us / cached_us);
+        Bench::report(label + " flow field, already resolved", cached_us, note);
+    }
+} // namespace
+
+namespace
+{
+    /**
+     * The player jumping between two rooms of a floor, each step restarting the map with a
+     * time budget: the recompute is spread over get() and then advance() calls, none of which
+     * may take longer than the budget. Also what slicing costs over solving in one go.
+     */
+    void compare_budgeted(const std::string &label, const Dungeon &d, DistanceMaps::Movement movement,
+                          std::chrono::microseconds budget)
+    {
+        using clock = std::chrono::steady_clock;
+        const Dungeon::RoomData &a = d.rooms.front(), &b = d.rooms.back();
+
+        DistanceMaps maps(d.width, d.height);
+        bool at_a = false;
+        auto step = [&]
+        {
+            at_a = !at_a;
+            return at_a ? std::make_pair(a.center_x, a.center_y) : std::make_pair(b.center_x, b.center_y);
+        };
+
+        double full_us = Bench::measure([&]
+                                        {
+            auto [x, y] = step();
+            Bench::keep(maps.get(movement, d, x, y).data()[0]); });
+
+        // Every call timed on its own. The longest call of each round, at best over a few
+        // rounds: a scheduler hiccup lands in one round, a slice that really overruns in all
+        maps.set_budget(budget);
+        const std::size_t rounds = 10, recomputes = 5;
+        double longest_us = 1e300, round_longest_us = 0;
+        std::size_t slices = 0;
+        auto timed = [&](auto &&call)
+        {
+            auto t0 = clock::now();
+            bool result = call();
+            round_longest_us = std::max(round_longest_us, std::chrono::duration<double, std::micro>(clock::now() - t0).count());
+            ++slices;
+            return result;
+        };
+        for (std::size_t round = 0; round < rounds; ++round)
+        {
+            round_longest_us = 0;
+            for (std::size_t i = 0; i < recomputes; ++i)
+            {
+                auto [x, y] = step();
+                timed([&]
+                      { Bench::keep(maps.get(movement, d, x, y).data()[0]); return true; });
+                while (!timed([&]
+                              { return maps.advance(d, budget); }))
+                {
+                }
+            }
+            longest_us = std::min(longest_us, round_longest_us);
+        }
+
+        double sliced_us = Bench::measure([&]
+                                          {
+            auto [x, y] = step();
+            Bench::keep(maps.get(movement, d, x, y).data()[0]);
+            while (!maps.advance(d, budget))
+            {
+            } });
+
+        char note[128];
+        std::snprintf(note, sizeof(note), "%.1f calls each, longest %.0f us, %s, %+.1f%% total",
+                      double(slices) / (rounds * recomputes), longest_us,
+                      longest_us < budget.count() ? "within budget" : "OVER BUDGET",
+                      100.0 * (sliced_us - full_us) / full_us);
+        Bench::report(label + " in one go", full_us);
+        Bench::report(label + " sliced", sliced_us, note);
+    }
+} // namespace
+
+namespace
+{
+    // Items coming and going on a map towards the nearest of many: a full multi-source solve
+    // against GoalMap's in-place repair when one goal is removed and added back
+    void compare_goal_map(const std::string &label, const Grid<unsigned char> &hardness, std::size_t goals)
+    {
+        const std::size_t w = hardness.width(), h = hardness.height();
+        OpenCost cost{hardness.data()};
+
+        std::mt19937 rng(23);
+        std::vector<std::size_t> sources;
+        while (sources.size() < goals)
+        {
+            std::size_t idx = rng() % (w * h);
+            if (hardness.data()[idx] == 0)
+                sources.push_back(idx);
+        }
+
+        Pathing::Workspace ws;
+        Grid<Pathing::cost_t> dist(w, h);
+        double full_us = Bench::measure([&]
+                                        {
+            Pathing::solve_begin(ws, dist, sources);
+            Pathing::solve_resume(ws, dist, cost, SIZE_MAX); });
+
+        Pathing::GoalMap map;
+        map.reset(w, h);
+        for (std::size_t idx : sources)
+            map.set_goal(idx, true, cost);
+        map.get(cost);
+
+        std::size_t ops = 0;
+        std::size_t before = map.expanded();
+        double toggle_us = Bench::measure([&]
+                                          {
+            std::size_t idx = sources[rng() % sources.size()];
+            map.set_goal(idx, false, cost);
+            map.set_goal(idx, true, cost);
+            ops += 2; });
+
+        char note[96];
+        std::snprintf(note, sizeof(note), "%zu goals", goals);
+        Bench::report(label + " full solve", full_us, note);
+        std::snprintf(note, sizeof(note), "x%.1f, %.0f expanded avg", full_us / (toggle_us / 2),
+                      double(map.expanded() - before) / ops);
+        Bench::report(label + " goal removed or added", toggle_us / 2, note);
+    }
+} // namespace
+
+void bench_pathing()
+{
+    Bench::header("pathing: heap vs bucket frontier");
+
+    Dungeon d = Bench::make_dungeon(1);
+    std::size_t start = d.rooms[0].center_y * d.width + d.rooms[0].center_x;
+
+    Grid<unsigned char> open(d.width, d.height, 255);
+    for (std::size_t i = 0; i < std::size_t(d.width) * d.height; ++i)
+        open.data()[i] = d.type_grid.data()[i] == Dungeon::CELL_ROCK ? 255 : 0;
+
+    compare_frontiers("80x21 tunneling", d.hardness_grid, start, TunnelingCost{d.hardness_grid.data()}, 3);
+    compare_frontiers("80x21 non-tunneling", open, start, OpenCost{open.data()}, 1);
+
+    Grid<unsigned char> big = Bench::make_hardness(1000, 1000, 1);
+    std::size_t big_start = 500 * 1000 + 500;
+    while (big.data()[big_start] != 0) // start inside a cave so both maps have work to do
+        ++big_start;
+    compare_frontiers("1000x1000 tunneling", big, big_start, TunnelingCost{big.data()}, 3);
+    compare_frontiers("1000x1000 non-tunneling", big, big_start, OpenCost{big.data()}, 1);
+
+    Bench::header("pathing: point-to-point walking queries");
+
+    Grid<unsigned char> floor_blocked(d.width, d.height);
+    for (std::size_t i = 0; i < std::size_t(d.width) * d.height; ++i)
+        floor_blocked.data()[i] = open.data()[i] != 0;
+    compare_point_queries("80x21 floor", floor_blocked, 200);
+
+    Grid<unsigned char> cave_blocked(1000, 1000);
+    for (std::size_t i = 0; i < 1000 * 1000; ++i)
+        cave_blocked.data()[i] = big.data()[i] != 0;
+    compare_point_queries("1000x1000 cave", cave_blocked, 20);
+
+    Bench::header("pathing: monster moves, neighbor scan vs flow field");
+
+    {
+        Pathing::BucketWorkspace ws(3);
+        Grid<Pathing::cost_t> dist(d.width, d.height);
+        Pathing::solve(ws, dist, start, TunnelingCost{d.hardness_grid.data()});
+        compare_flow("80x21", dist, 1000);
+
+        Grid<Pathing::cost_t> big_dist(1000, 1000);
+        Pathing::solve(ws, big_dist, big_start, TunnelingCost{big.data()});
+        compare_flow("1000x1000", big_dist, 10000);
+    }
+
+    Bench::header("pathing: nearest-goal map, one goal removed or added");
+
+    compare_goal_map("80x21 floor", open, 10);
+    compare_goal_map("1000x1000 cave", big, 1000);
+
+    Bench::header("pathing: distance maps recomputed under a 250 us budget");
+
+    {
+        // The largest floor a mapsize_t allows, crowded with rooms
+        auto params = Bench::default_params();
+        params.min_num_rooms = 60;
+        params.max_num_rooms = 80;
+        Dungeon largest(255, 255);
+        Dungeon::Generator().generate_dungeon(largest, params, 3);
+
+        const std::chrono::microseconds budget(250);
+        compare_budgeted("255x255 tunneling", largest, DistanceMaps::Movement::TUNNELING, budget);
+        compare_budgeted("255x255 walking", largest, DistanceMaps::Movement::WALKING, budget);
+    }
+
+    Bench::header("pathing: incremental repair after mining one cell");
+
+    for (std::size_t size : {80, 1000})
+    {
+        Grid<unsigned char> hardness = size == 80 ? d.hardness_grid : big;
+        std::size_t src = size == 80 ? start : big_start;
+        std::size_t w = hardness.width();
+
+        Pathing::BucketWorkspace ws(3);
+        Grid<Pathing::cost_t> dist(w, hardness.height());
+
+        double full_us = Bench::measure([&]
+                                        { Pathing::solve(ws, dist, src, TunnelingCost{hardness.data()}); });
+
+        // Mine a ring of rock cells around the source, one per call, like a tunneler would
+        std::mt19937 rng(7);
+        std::size_t expanded = 0, repairs = 0;
+        double repair_us = Bench::measure([&]
+                                          {
+            std::size_t idx = (1 + rng() % (hardness.height() - 2)) * w + 1 + rng() % (w - 2);
+            unsigned char &h = hardness.data()[idx];
+            h = h > 85 ? h - 85 : 0;
+            expanded += Pathing::repair_decrease(ws, dist, idx, TunnelingCost{hardness.data()});
+            ++repairs; });
+
+        std::string label = size == 80 ? "80x21" : "1000x1000";
+        Bench::report(label + " full solve", full_us);
+
+        char note[64];
+        std::snprintf(note, sizeof(note), "x%.1f, %.1f expanded avg", full_us / repair_us,
+                      double(expanded) / repairs);
+        Bench::report(label + " repair_decrease", repair_us, note);
+    }
+}
@@ -0,0 +1,112 @@
+#include "bench.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "game_context.hpp"
+#include "monster.hpp"
+
+namespace
+{
+    const short PALETTE[] = {1};
+
+    struct Run
+    {
+        double us_per_turn;   // mean time of one process_events(), one player turn of monster moves
+        std::uint64_t state;  // hash of every monster and every cell once the turns are over
+    };
+
+    std::uint64_t mix(std::uint64_t h, std::uint64_t value)
+    {
+        return (h ^ value) * 1099511628211ull; // FNV-1a
+    }
+
+    /**
+     * A big floor crowded with monsters of every movement kind, played for `turns` player
+     * turns with `workers` decision threads. The player has no ui, so its turns are skipped
+     * and it is walked by hand between them; every draw comes from fixed seeds.
+     */
+    Run play(const Dungeon &floor, std::size_t count, std::size_t turns, std::size_t workers)
+    {
+        using A = Monster::Abilities;
+        const A kinds[] = {A::NONE, A::INTELLIGENT, A(unsigned(A::INTELLIGENT) | unsigned(A::TELEPATHIC)),
+                           A::TUNNELING, A(unsigned(A::INTELLIGENT) | unsigned(A::TELEPATHIC) | unsigned(A::TUNNELING)),
+                           A::ERRATIC, A::TELEPATHIC, A::PICKUP};
+        // Few speeds, so whole crowds fall due on the same tick and batches are worth splitting
+        const int speeds[] = {5, 10, 20};
+
+        std::srand(7); // erratic monsters roll with rand()
+        std::mt19937 rng(1);
+        Dungeon d = floor;
+        GameContext g(Bench::default_params(), d.width, d.height, 0, {}, {}, 1);
+        g.set_dungeon(d, d.rooms[0].center_x, d.rooms[0].center_y);
+        g.set_decision_threads(workers);
+
+        for (std::size_t i = 0; i < count;)
+        {
+            mapsize_t x = rng() % d.width, y = rng() % d.height;
+            if (g.dungeon.type_grid(x, y) == Dungeon::CELL_ROCK)
+                continue;
+            Monster *m = g.add_entity(Monster(x, y, 'm', PALETTE, speeds[rng() % 3], 1000000,
+                                              kinds[rng() % 8], nullptr, Dice(0, 0, 0)));
+            g.schedule_character_event(m);
+            ++i;
+        }
+        g.update_on_change();
+
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t turn = 0; turn < turns; ++turn)
+        {
+            g.process_events();
+
+            mapsize_t x = g.player.x + int(rng() % 3) - 1, y = g.player.y + int(rng() % 3) - 1;
+            if (g.dungeon.type_grid(x, y) != Dungeon::CELL_ROCK)
+                g.move_entity(&g.player, g.player.x, g.player.y, x, y);
+            g.update_on_change();
+        }
+        std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::uint64_t h = 1469598103934665603ull;
+        for (const Monster *m : g.filter<Monster>())
+        {
+            h = mix(h, m->x);
+            h = mix(h, m->y);
+            h = mix(h, m->active);
+        }
+        for (std::size_t y = 0; y < d.height; ++y)
+            for (std::size_t x = 0; x < d.width; ++x)
+                h = mix(h, g.dungeon.type_grid(x, y));
+        return {elapsed.count() / turns, h};
+    }
+
+    // Planning on worker threads must not change a single move: same floor, same seeds,
+    // compared after every monster has moved dozens of times
+    void compare_workers(const std::string &label, const Dungeon &floor, std::size_t count,
+                         std::size_t turns, std::size_t workers)
+    {
+        Run serial = play(floor, count, turns, 0);
+        Run parallel = play(floor, count, turns, workers);
+
+        Bench::report(label + " 0 workers, per player turn", serial.us_per_turn);
+        char note[64];
+        std::snprintf(note, sizeof(note), "x%.2f, %s", serial.us_per_turn / parallel.us_per_turn,
+                      serial.state == parallel.state ? "identical" : "differ");
+        Bench::report(label + " " + std::to_string(workers) + " workers, per player turn",
+                      parallel.us_per_turn, note);
+    }
+} // namespace
+
+void bench_turns()
+{
+    Bench::header("turns: monster turns with decisions planned on 0 vs N threads");
+
+    auto params = Bench::default_params();
+    params.min_num_rooms = 60;
+    params.max_num_rooms = 80;
+    Dungeon floor(250, 250);
+    Dungeon::Generator().generate_dungeon(floor, params, 3);
+
+    compare_workers("250x250, 2000 monsters,", floor, 2000, 40, 3);
+    compare_workers("250x250, 8000 monsters,", floor, 8000, 20, 3);
+}
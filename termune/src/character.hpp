@@ -2,12 +2,20 @@
 
 #include "entity.hpp"
 #include "util/dice.hpp"
+#include "util/timing_wheel.hpp"
+
+class Character;
+
+// Turn delays are short and dense, which a timing wheel pops in O(1); EventQueue is a drop-in heap
+using TurnQueue = TimingWheel<Character>;
 
 class Character : public Entity
 {
 public:
-    Character(mapsize_t x, mapsize_t y, char sym, const std::vector<short> &cols, int speed, int max_health, const Dice &damage, int zindex = 0)
-        : Entity(x, y, sym, cols, zindex), speed(speed), health(max_health), health_max(max_health), damage(damage) {}
+    Character(EntityKind kind, mapsize_t x, mapsize_t y, char sym, ColorList cols, int speed, int max_health, const Dice &damage, int zindex = 0)
+        : Entity(kind, x, y, sym, cols, zindex), speed(speed), health(max_health), health_max(max_health), damage(damage) {}
+
+    static constexpr bool is_kind(EntityKind k) { return k == EntityKind::PLAYER || k == EntityKind::MONSTER; }
 
     virtual int event_delay() const { return 1000 / speed; }
 
@@ -21,4 +29,6 @@ public:
     int health = 0;
     int health_max = 0;
     Dice damage;
+
+    TurnQueue::Handle turn_event = TurnQueue::NO_EVENT; // next turn, while scheduled
 };
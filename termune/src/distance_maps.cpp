@@ -0,0 +1,248 @@
+#include "distance_maps.hpp"
+
+#include <limits>
+#include <algorithm>
+
+// Largest step cost in either distance map (tunneling through hardness 254)
+static constexpr Pathing::cost_t MAX_DISTANCE_STEP = 1 + 254 / 85;
+
+// Walking maps use bit BFS, which only pays off on small grids: x1.4-2 on an 80x21 floor, about
+// even at 256x256, 2-3x slower on a 1000x1000 cave (termune_bench distance). Floors stay below.
+static constexpr std::size_t BIT_BFS_MAX_CELLS = 256 * 256;
+static_assert(std::size_t(std::numeric_limits<mapsize_t>::max()) * std::numeric_limits<mapsize_t>::max() <= BIT_BFS_MAX_CELLS,
+              "walking maps on floors this large should use the bucket queue");
+
+namespace // hide from other translation units
+{
+    struct TunnelingCost
+    {
+        const Dungeon::cell_hardness_t *hardness;
+
+        Pathing::cost_t operator()(std::size_t, std::size_t to) const
+        {
+            return hardness[to] < 255 ? Pathing::cost_t(1 + hardness[to] / 85)
+                                      : Pathing::UNREACHABLE;
+        }
+    };
+
+    struct WalkingCost
+    {
+        const BitGrid *rock;
+
+        Pathing::cost_t operator()(std::size_t, std::size_t to) const
+        {
+            return rock->at(to % rock->width(), to / rock->width()) ? Pathing::UNREACHABLE
+                                                                    : Pathing::cost_t(1);
+        }
+    };
+} // namespace
+
+DistanceMaps::Entry::Entry(mapsize_t width, mapsize_t height)
+    : map(width, height, Pathing::UNREACHABLE),
+      pending(width, height, Pathing::UNREACHABLE),
+      path_workspace(MAX_DISTANCE_STEP)
+{
+}
+
+DistanceMaps::DistanceMaps(mapsize_t width, mapsize_t height)
+    : width_(width),
+      entries_{Entry(width, height), Entry(width, height)},
+      repair_workspace_(MAX_DISTANCE_STEP)
+{
+}
+
+const Grid<Pathing::cost_t> &DistanceMaps::get(Movement movement, const Dungeon &dungeon,
+                                               mapsize_t source_x, mapsize_t source_y)
+{
+    Entry &entry = entries_[static_cast<std::size_t>(movement)];
+
+    // A running solve is finished before the next one starts, so a moving player can't starve it
+    if (!entry.solving && (!entry.valid || entry.source_x != source_x || entry.source_y != source_y))
+    {
+        // The budget covers setting the solve up too, which touches the whole map
+        using clock = std::chrono::steady_clock;
+        const auto deadline = budget_.count() > 0 ? clock::now() + budget_ : clock::time_point::max();
+        begin(movement, entry, dungeon, source_x, source_y);
+        resume(movement, entry, dungeon, deadline);
+    }
+
+    if (!entry.valid) // nothing older to fall back on
+        resume(movement, entry, dungeon, std::chrono::steady_clock::time_point::max());
+    else if (entry.source_x != source_x || entry.source_y != source_y)
+        ++stats_.stale;
+
+    if (entry.terrain_version != terrain_version_)
+    {
+        for (unsigned long v = entry.terrain_version; v < terrain_version_; ++v)
+            repair(movement, entry, dungeon, changes_[v - changes_base_]);
+        entry.terrain_version = terrain_version_;
+        entry.flow_current = false;
+        trim_changes();
+    }
+    else
+    {
+        ++stats_.hits;
+    }
+
+    return entry.map;
+}
+
+bool DistanceMaps::advance(const Dungeon &dungeon, std::chrono::microseconds budget)
+{
+    using clock = std::chrono::steady_clock;
+    const auto deadline = clock::now() + budget;
+
+    bool idle = true;
+    for (std::size_t i = 0; i < entries_.size(); ++i)
+    {
+        Entry &entry = entries_[i];
+        if (!entry.solving)
+            continue;
+
+        if (clock::now() >= deadline || !resume(static_cast<Movement>(i), entry, dungeon, deadline))
+            idle = false;
+    }
+    return idle;
+}
+
+Pathing::FlowField &DistanceMaps::flow(Movement movement, const Dungeon &dungeon,
+                                       mapsize_t source_x, mapsize_t source_y)
+{
+    const Grid<Pathing::cost_t> &map = get(movement, dungeon, source_x, source_y);
+
+    Entry &entry = entries_[static_cast<std::size_t>(movement)];
+    if (!entry.flow_current)
+    {
+        entry.flow.reset(map);
+        entry.flow_current = true;
+    }
+    return entry.flow;
+}
+
+void DistanceMaps::terrain_changed(mapsize_t x, mapsize_t y)
+{
+    ++terrain_version_;
+
+    // Nobody will need the change if every map is getting recomputed anyway
+    if (std::any_of(entries_.begin(), entries_.end(), [](const Entry &e)
+                    { return e.valid || e.solving; }))
+        changes_.push_back(x + y * width_);
+    else
+        changes_base_ = terrain_version_;
+}
+
+void DistanceMaps::invalidate()
+{
+    for (Entry &entry : entries_)
+        entry.valid = entry.solving = false;
+    changes_.clear();
+    changes_base_ = terrain_version_;
+}
+
+void DistanceMaps::begin(Movement movement, Entry &entry, const Dungeon &dungeon,
+                         mapsize_t source_x, mapsize_t source_y)
+{
+    entry.solving = true;
+    entry.pending_x = source_x;
+    entry.pending_y = source_y;
+    entry.pending_version = terrain_version_;
+
+    std::size_t start = source_x + source_y * width_;
+    switch (movement)
+    {
+    case Movement::TUNNELING:
+        Pathing::solve_begin(entry.path_workspace, entry.pending, start);
+        break;
+    case Movement::WALKING:
+        DistanceTransform::bit_bfs_begin(entry.distance_workspace, dungeon.rock_grid, start, entry.pending);
+        break;
+    case Movement::COUNT:
+        break;
+    }
+}
+
+bool DistanceMaps::resume(Movement movement, Entry &entry, const Dungeon &dungeon,
+                          std::chrono::steady_clock::time_point deadline)
+{
+    using clock = std::chrono::steady_clock;
+    const bool limited = deadline != clock::time_point::max();
+
+    // Check the clock between chunks of work, not after every cell. An expansion costs the same
+    // on any map, a BFS level up to a word per 64 cells of it, so levels are counted in words
+    constexpr std::size_t EXPANSIONS_PER_CHUNK = 256;
+    constexpr std::size_t WORDS_PER_CHUNK = 1024;
+    const std::size_t level_words = dungeon.rock_grid.words_per_row() * dungeon.height;
+    const std::size_t levels_per_chunk = std::max<std::size_t>(1, WORDS_PER_CHUNK / level_words);
+
+    bool done = false;
+    while (!done)
+    {
+        const auto chunk_start = clock::now();
+        ++stats_.slices;
+        switch (movement)
+        {
+        case Movement::TUNNELING:
+            // Costs are read live: mining mid-solve only lowers them, repaired once done
+            done = Pathing::solve_resume(entry.path_workspace, entry.pending,
+                                         TunnelingCost{dungeon.hardness_grid.data()},
+                                         limited ? EXPANSIONS_PER_CHUNK : SIZE_MAX);
+            break;
+        case Movement::WALKING:
+            done = DistanceTransform::bit_bfs_resume(entry.distance_workspace, entry.pending,
+                                                     limited ? levels_per_chunk : SIZE_MAX);
+            break;
+        case Movement::COUNT:
+            done = true;
+            break;
+        }
+
+        // Stop unless two chunks like the last one still fit, chunks grow with the frontier
+        const auto now = clock::now();
+        if (!done && limited && now + 2 * (now - chunk_start) >= deadline)
+            return false;
+    }
+
+    // Swap the finished map in; changes made while it was solving get repaired on the next get()
+    std::swap(entry.map, entry.pending);
+    entry.valid = true;
+    entry.solving = false;
+    entry.source_x = entry.pending_x;
+    entry.source_y = entry.pending_y;
+    entry.terrain_version = entry.pending_version;
+    entry.flow_current = false;
+    ++stats_.computes;
+    return true;
+}
+
+void DistanceMaps::repair(Movement movement, Entry &entry, const Dungeon &dungeon, std::size_t idx)
+{
+    // Mining only ever lowers hardness or opens rock, so the map can be repaired in place
+    switch (movement)
+    {
+    case Movement::TUNNELING:
+        Pathing::repair_decrease(repair_workspace_, entry.map, idx, TunnelingCost{dungeon.hardness_grid.data()});
+        break;
+    case Movement::WALKING:
+        Pathing::repair_decrease(repair_workspace_, entry.map, idx, WalkingCost{&dungeon.rock_grid});
+        break;
+    case Movement::COUNT:
+        break;
+    }
+    ++stats_.repairs;
+}
+
+void DistanceMaps::trim_changes()
+{
+    // Drop the changes every map, finished or not, has already caught up with
+    unsigned long oldest = terrain_version_;
+    for (const Entry &entry : entries_)
+    {
+        if (entry.valid)
+            oldest = std::min(oldest, entry.terrain_version);
+        if (entry.solving)
+            oldest = std::min(oldest, entry.pending_version);
+    }
+
+    changes_.erase(changes_.begin(), changes_.begin() + (oldest - changes_base_));
+    changes_base_ = oldest;
+}
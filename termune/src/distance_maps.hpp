@@ -0,0 +1,109 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <chrono>
+#include <cstddef>
+
+#include "types.hpp"
+#include "dungeon.hpp"
+#include "util/grid.hpp"
+#include "util/pathing.hpp"
+#include "util/flow_field.hpp"
+#include "util/distance_transform.hpp"
+
+/**
+ * Monster distance maps towards the player, one per movement class. A map is only computed
+ * when a monster asks for it, and remembers what it was computed from (player position and
+ * terrain version), so asking again after nothing changed is free. Terrain changes since then
+ * are repaired in place, a player move recomputes the map from scratch.
+ *
+ * With a time budget set, a recompute is sliced: it runs for at most the budget per call and
+ * is continued by advance(), while monsters keep getting the last complete map. Without one
+ * (the default) every map is finished before get() returns.
+ */
+class DistanceMaps
+{
+public:
+    enum class Movement
+    {
+        TUNNELING, // through rock, slower the harder it is
+        WALKING,   // open cells only
+        COUNT
+    };
+
+    DistanceMaps(mapsize_t width, mapsize_t height);
+
+    /** The map for `movement` towards (source_x, source_y), brought up to date first. */
+    const Grid<Pathing::cost_t> &get(Movement movement, const Dungeon &dungeon,
+                                     mapsize_t source_x, mapsize_t source_y);
+
+    /** Best move out of every cell of the same map, cleared only when the map changed. */
+    Pathing::FlowField &flow(Movement movement, const Dungeon &dungeon,
+                             mapsize_t source_x, mapsize_t source_y);
+
+    /** Longest a single get() may spend on a recompute, zero for no limit. */
+    void set_budget(std::chrono::microseconds budget) { budget_ = budget; }
+
+    /** Continue unfinished recomputes for up to `budget`, true when none are left. */
+    bool advance(const Dungeon &dungeon, std::chrono::microseconds budget);
+
+    /** A cell's hardness dropped or its rock was cleared. */
+    void terrain_changed(mapsize_t x, mapsize_t y);
+
+    /** Forget every map, e.g. for a new floor. */
+    void invalidate();
+
+    struct Stats
+    {
+        std::size_t computes = 0; /**< Full solves */
+        std::size_t repairs = 0;  /**< Terrain changes repaired in place */
+        std::size_t hits = 0;     /**< Requests answered without any work */
+        std::size_t stale = 0;    /**< Requests answered with the previous map, a recompute still running */
+        std::size_t slices = 0;   /**< Budgeted recompute steps */
+    };
+    const Stats &stats() const { return stats_; }
+
+private:
+    struct Entry
+    {
+        Entry(mapsize_t width, mapsize_t height);
+
+        // The complete map handed out to monsters
+        Grid<Pathing::cost_t> map;
+        bool valid = false;
+        mapsize_t source_x = 0, source_y = 0;
+        unsigned long terrain_version = 0; /**< Terrain changes already reflected in the map */
+        Pathing::FlowField flow;
+        bool flow_current = false; /**< flow was reset since the map last changed */
+
+        // Its replacement, computed in slices
+        Grid<Pathing::cost_t> pending;
+        bool solving = false;
+        mapsize_t pending_x = 0, pending_y = 0;
+        unsigned long pending_version = 0; /**< Terrain version when the solve began */
+        Pathing::BucketWorkspace path_workspace;
+        DistanceTransform::Workspace distance_workspace;
+    };
+
+    void begin(Movement movement, Entry &entry, const Dungeon &dungeon,
+               mapsize_t source_x, mapsize_t source_y);
+    // Runs until done, or stops before passing `deadline` (time_point::max() for no limit)
+    bool resume(Movement movement, Entry &entry, const Dungeon &dungeon,
+                std::chrono::steady_clock::time_point deadline);
+    void repair(Movement movement, Entry &entry, const Dungeon &dungeon, std::size_t idx);
+    void trim_changes();
+
+    mapsize_t width_;
+    std::array<Entry, static_cast<std::size_t>(Movement::COUNT)> entries_;
+
+    // Cells changed since the oldest valid map, changes_[i] is terrain version changes_base_ + i + 1
+    unsigned long terrain_version_ = 0;
+    unsigned long changes_base_ = 0;
+    std::vector<std::size_t> changes_;
+
+    Pathing::BucketWorkspace repair_workspace_; // never in the middle of a sliced solve
+    std::chrono::microseconds budget_{0};
+
+    Stats stats_;
+};
@@ -154,5 +154,13 @@ Dungeon Dungeon::deserialize(std::istream &in, mapsize_t &pc_x, mapsize_t &pc_y)
     read_stairs(CELL_STAIR_UP);
     read_stairs(CELL_STAIR_DOWN);
 
+    dungeon.update_rock_grid();
     return dungeon;
 }
+
+void Dungeon::update_rock_grid()
+{
+    for (mapsize_t y = 0; y < height; ++y)
+        for (mapsize_t x = 0; x < width; ++x)
+            rock_grid.set(x, y, type_grid.at(x, y) == CELL_ROCK);
+}
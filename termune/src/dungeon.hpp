@@ -5,11 +5,13 @@
 
 #include "types.hpp"
 #include "util/grid.hpp"
+#include "util/bit_grid.hpp"
+#include "util/pathing.hpp"
 
 class Dungeon
 {
 public:
-    enum cell_type_t
+    enum cell_type_t : unsigned char
     {
         CELL_ROCK,
         CELL_ROOM,
@@ -48,7 +50,8 @@ public:
     Dungeon(mapsize_t width, mapsize_t height)
         : width(width), height(height),
           type_grid(width, height, CELL_ROCK),
-          hardness_grid(width, height, 0) {}
+          hardness_grid(width, height, 0),
+          rock_grid(width, height, true) {}
 
     void serialize(std::ostream &out, mapsize_t pc_x, mapsize_t pc_y) const;
     static Dungeon deserialize(std::istream &in, mapsize_t &pc_x, mapsize_t &pc_y);
@@ -65,6 +68,16 @@ public:
         cell_hardness_t hardness;
     };
 
+    // Changes a cell's type, keeping rock_grid in sync
+    void set_type(mapsize_t x, mapsize_t y, cell_type_t type)
+    {
+        type_grid.at(x, y) = type;
+        rock_grid.set(x, y, type == CELL_ROCK);
+    }
+
+    // Rederives rock_grid after type_grid was written directly (generating, loading)
+    void update_rock_grid();
+
     dungeon_cell_t at(int x, int y) const
     {
         return dungeon_cell_t{
@@ -77,6 +90,7 @@ public:
     mapsize_t height;
     Grid<cell_type_t> type_grid;
     Grid<cell_hardness_t> hardness_grid;
+    BitGrid rock_grid; // rock cells, the one layer light, walking and pathing all read
     std::vector<RoomData> rooms;
 
 public:
@@ -104,6 +118,18 @@ public:
             float rock_hardness_noise_amount;
         };
 
-        static void generate_dungeon(Dungeon &dungeon, const Parameters &params, int seed);
+        struct Stats
+        {
+            std::size_t corridor_searches = 0;   /**< Room pairs routed */
+            std::size_t corridor_expansions = 0; /**< Nodes expanded while routing corridors */
+        };
+
+        void generate_dungeon(Dungeon &dungeon, const Parameters &params, int seed = 0, Stats *stats = nullptr);
+
+    private:
+        // Corridor routing scratch, reused by every room pair and every floor this generator builds
+        Pathing::Workspace workspace;
+        Grid<Pathing::cost_t> corridor_cost{0, 0};
+        std::vector<std::size_t> path;
     };
 };
\ No newline at end of file
@@ -1,4 +1,7 @@
 #include "entity.hpp"
+
+#include <vector>
+
 #include "game_context.hpp"
 #include "ui.hpp"
 
@@ -25,13 +28,31 @@ bool Entity::move(int dx, int dy, GameContext &g, bool force)
     if (!force && g.dungeon.type_grid.at(target_x, target_y) == Dungeon::CELL_ROCK)
         return false;
 
-    for (auto &entity : g.entities_at(target_x, target_y))
+    // Only a hit wakes a character up, bumping into it does not
+    auto health = [](Entity *e)
+    {
+        auto *c = e->as<Character>();
+        return c ? c->health : 0;
+    };
+
+    // The callbacks below may relink occupants, so walk a copy of the cell's chain
+    const auto range = g.entities_at(target_x, target_y);
+    const std::vector<Entity *> occupants(range.begin(), range.end());
+    for (Entity *entity : occupants)
     {
         if (entity == this)
             continue;
 
+        const int entity_health = health(entity), own_health = health(this);
         entity->on_collision(*this);
+        if (health(entity) < entity_health)
+            g.update_on_damage(entity);
+        if (health(this) < own_health)
+            g.update_on_damage(this);
+        if (entity == &g.player || this == &g.player) // monsters only fight the player
+            g.make_noise(target_x, target_y, COMBAT_NOISE_RADIUS);
     }
+    g.update_on_item_change(target_x, target_y); // the move may have picked something up
 
     g.move_entity(this, x, y, target_x, target_y);
 
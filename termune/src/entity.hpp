@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <string>
+#include <cstdint>
 #include "types.hpp"
 #include "util/colors.hpp"
 
@@ -12,6 +13,28 @@ namespace ui
     class Context;
 }
 
+// The concrete type of an Entity, which as<T>() checks instead of RTTI
+enum class EntityKind : unsigned char
+{
+    PLAYER,
+    MONSTER,
+    OBJECT,
+};
+
+// Names an entity held by an EntityStore. Once the entity is removed its slot gets a new
+// generation, so old handles stop resolving instead of pointing at whatever reuses the slot.
+struct EntityHandle
+{
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    uint32_t slot = NONE;
+    uint32_t generation = 0;
+
+    explicit operator bool() const { return slot != NONE; }
+    bool operator==(const EntityHandle &o) const { return slot == o.slot && generation == o.generation; }
+    bool operator!=(const EntityHandle &o) const { return !(*this == o); }
+};
+
 class Entity
 {
 public:
@@ -19,11 +42,13 @@ public:
     char symbol;
     int z;
 
-    std::vector<short> colors;
+    ColorList colors; // whoever constructs the entity keeps these alive, usually its description
     bool active = true;
 
-    Entity(mapsize_t x, mapsize_t y, char sym, std::vector<short> cols, int zindex = 0)
-        : x(x), y(y), symbol(sym), z(zindex), colors(std::move(cols)) {}
+    const EntityKind kind;
+
+    Entity(EntityKind kind, mapsize_t x, mapsize_t y, char sym, ColorList cols, int zindex = 0)
+        : x(x), y(y), symbol(sym), z(zindex), colors(cols), kind(kind) {}
 
     virtual ~Entity() = default;
 
@@ -44,15 +69,26 @@ public:
     // Downcasting helper functions (used to downcast to derived types)
     // These are not safe, so wrap in a check for nullptr
     // `if (auto &derived = entity->as<DerivedType>()) { ... }` is safe
+    // Every derived type says which kinds it covers with a static is_kind()
     template <typename T>
     T *as()
     {
-        return dynamic_cast<T *>(this);
+        return T::is_kind(kind) ? static_cast<T *>(this) : nullptr;
     }
 
     template <typename T>
     const T *as() const
     {
-        return dynamic_cast<const T *>(this);
+        return T::is_kind(kind) ? static_cast<const T *>(this) : nullptr;
     }
+
+    static constexpr bool is_kind(EntityKind) { return true; }
+
+    EntityHandle handle() const { return handle_; } // empty until added to a store
+
+private:
+    friend class EntityStore;
+    friend class EntityGrid;
+    EntityHandle handle_;
+    Entity *next_in_cell = nullptr; // below this one on its cell, see EntityGrid
 };
@@ -0,0 +1,22 @@
+#include "entity_grid.hpp"
+
+void EntityGrid::link(Entity *e)
+{
+    // In front of the first entity it is not below
+    Entity **at = &heads.at(e->x, e->y);
+    while (*at && (*at)->z > e->z)
+        at = &(*at)->next_in_cell;
+    e->next_in_cell = *at;
+    *at = e;
+}
+
+void EntityGrid::unlink(Entity *e)
+{
+    for (Entity **at = &heads.at(e->x, e->y); *at; at = &(*at)->next_in_cell)
+        if (*at == e)
+        {
+            *at = e->next_in_cell;
+            e->next_in_cell = nullptr;
+            return;
+        }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <iterator>
+#include <cstddef>
+
+#include "types.hpp"
+#include "entity.hpp"
+#include "util/grid.hpp"
+
+/**
+ * Which entities stand on each cell, as an intrusive chain: the grid holds the first entity
+ * of every cell and each entity the one after it. A chain runs highest z first, the newest of
+ * equal z ahead, so a cell's head is what gets drawn there and finding it is a single load.
+ * Nothing is allocated per occupant, and linking or unlinking only walks that cell's chain.
+ *
+ * An entity is linked at its own x, y, so unlink it before moving it and link it again after.
+ */
+class EntityGrid
+{
+public:
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Entity *;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Entity *const *;
+        using reference = Entity *const &;
+
+        explicit Iterator(Entity *e = nullptr) : e(e) {}
+
+        reference operator*() const { return e; }
+        Iterator &operator++()
+        {
+            e = e->next_in_cell;
+            return *this;
+        }
+        Iterator operator++(int)
+        {
+            Iterator old = *this;
+            ++*this;
+            return old;
+        }
+        bool operator==(const Iterator &o) const { return e == o.e; }
+        bool operator!=(const Iterator &o) const { return e != o.e; }
+
+    private:
+        Entity *e;
+    };
+
+    /** The occupants of one cell, top first. Linking or unlinking on that cell invalidates it. */
+    struct Range
+    {
+        Entity *head;
+
+        Iterator begin() const { return Iterator(head); }
+        Iterator end() const { return Iterator(); }
+        bool empty() const { return !head; }
+    };
+
+    EntityGrid(mapsize_t width, mapsize_t height) : heads(width, height, nullptr) {}
+
+    void link(Entity *e);
+    void unlink(Entity *e); // a no-op when `e` is not linked
+    void clear() { heads.fill(nullptr); }
+
+    Entity *top(mapsize_t x, mapsize_t y) const { return heads.at(x, y); }
+    Range at(mapsize_t x, mapsize_t y) const { return {heads.at(x, y)}; }
+
+private:
+    Grid<Entity *> heads;
+};
@@ -0,0 +1,207 @@
+#include "entity_store.hpp"
+
+#include <algorithm>
+#include <type_traits>
+
+std::size_t EntityStore::MonsterTable::alive() const
+{
+    return std::count(active.begin(), active.end(), 1);
+}
+
+Monster *EntityStore::add(Monster m)
+{
+    Monster *e = monster_pool_.create(std::move(m));
+    acquire_slot(e, monsters_.size());
+    monsters_.object.push_back(e);
+    monsters_.x.push_back(e->x);
+    monsters_.y.push_back(e->y);
+    monsters_.speed.push_back(e->speed);
+    monsters_.health.push_back(e->health);
+    monsters_.abilities.push_back(e->abilities);
+    monsters_.symbol.push_back(e->symbol);
+    monsters_.active.push_back(e->active);
+    return e;
+}
+
+ObjectEntity *EntityStore::add(ObjectEntity o)
+{
+    ObjectEntity *e = object_pool_.create(std::move(o));
+    acquire_slot(e, objects_.size());
+    objects_.object.push_back(e);
+    objects_.x.push_back(e->x);
+    objects_.y.push_back(e->y);
+    objects_.type.push_back(e->type);
+    objects_.symbol.push_back(e->symbol);
+    objects_.active.push_back(e->active);
+    return e;
+}
+
+bool EntityStore::remove(Entity *e)
+{
+    if (!contains(e))
+        return false;
+
+    if (e->as<Monster>())
+        remove_row(monsters_, row_of(e));
+    else
+        remove_row(objects_, row_of(e));
+    return true;
+}
+
+void EntityStore::remove_inactive(const std::function<void(Entity *)> &before)
+{
+    remove_inactive(monsters_, before);
+    remove_inactive(objects_, before);
+}
+
+void EntityStore::clear()
+{
+    // Destructors free nothing, the memory goes back in one reset
+    for (Monster *m : monsters_.object)
+    {
+        release_slot(m);
+        m->~Monster();
+    }
+    for (ObjectEntity *o : objects_.object)
+    {
+        release_slot(o);
+        o->~ObjectEntity();
+    }
+    resize(monsters_, 0);
+    resize(objects_, 0);
+    monster_pool_.reset();
+    object_pool_.reset();
+    arena_.reset();
+}
+
+bool EntityStore::contains(const Entity *e) const
+{
+    return get(e->handle_) == e;
+}
+
+Entity *EntityStore::get(EntityHandle h) const
+{
+    if (h.slot >= slots_.size() || slots_[h.slot].generation != h.generation)
+        return nullptr;
+
+    const Slot &slot = slots_[h.slot];
+    if (slot.kind == EntityKind::MONSTER)
+        return monsters_.object[slot.row];
+    return objects_.object[slot.row];
+}
+
+void EntityStore::sync(const Entity *e)
+{
+    if (auto *m = e->as<Monster>())
+    {
+        const std::size_t row = row_of(e);
+        monsters_.x[row] = m->x;
+        monsters_.y[row] = m->y;
+        monsters_.health[row] = m->health;
+        monsters_.active[row] = m->active;
+    }
+    else if (auto *o = e->as<ObjectEntity>())
+    {
+        const std::size_t row = row_of(e);
+        objects_.x[row] = o->x;
+        objects_.y[row] = o->y;
+        objects_.active[row] = o->active;
+    }
+}
+
+void EntityStore::acquire_slot(Entity *e, std::size_t row)
+{
+    uint32_t index;
+    if (!free_slots_.empty())
+    {
+        index = free_slots_.back();
+        free_slots_.pop_back();
+    }
+    else
+    {
+        index = static_cast<uint32_t>(slots_.size());
+        slots_.emplace_back();
+    }
+
+    Slot &slot = slots_[index];
+    slot.row = static_cast<uint32_t>(row);
+    slot.kind = e->kind;
+    e->handle_ = {index, slot.generation};
+}
+
+void EntityStore::release_slot(const Entity *e)
+{
+    ++slots_[e->handle_.slot].generation;
+    free_slots_.push_back(e->handle_.slot);
+}
+
+void EntityStore::move_row(MonsterTable &t, std::size_t from, std::size_t to)
+{
+    t.object[to] = t.object[from];
+    t.x[to] = t.x[from];
+    t.y[to] = t.y[from];
+    t.speed[to] = t.speed[from];
+    t.health[to] = t.health[from];
+    t.abilities[to] = t.abilities[from];
+    t.symbol[to] = t.symbol[from];
+    t.active[to] = t.active[from];
+    slots_[t.object[to]->handle_.slot].row = static_cast<uint32_t>(to);
+}
+
+void EntityStore::move_row(ObjectTable &t, std::size_t from, std::size_t to)
+{
+    t.object[to] = t.object[from];
+    t.x[to] = t.x[from];
+    t.y[to] = t.y[from];
+    t.type[to] = t.type[from];
+    t.symbol[to] = t.symbol[from];
+    t.active[to] = t.active[from];
+    slots_[t.object[to]->handle_.slot].row = static_cast<uint32_t>(to);
+}
+
+template <typename Table>
+void EntityStore::resize(Table &t, std::size_t rows)
+{
+    t.object.resize(rows);
+    t.x.resize(rows);
+    t.y.resize(rows);
+    t.symbol.resize(rows);
+    t.active.resize(rows);
+    if constexpr (std::is_same_v<Table, MonsterTable>)
+    {
+        t.speed.resize(rows);
+        t.health.resize(rows);
+        t.abilities.resize(rows);
+    }
+    else
+    {
+        t.type.resize(rows);
+    }
+}
+
+template <typename Table>
+void EntityStore::remove_row(Table &t, std::size_t row)
+{
+    release_slot(t.object[row]);
+    destroy(t.object[row]);
+    const std::size_t last = t.size() - 1;
+    if (row != last)
+        move_row(t, last, row);
+    resize(t, last);
+}
+
+template <typename Table>
+void EntityStore::remove_inactive(Table &t, const std::function<void(Entity *)> &before)
+{
+    // A removed row takes the last one, which is looked at next
+    for (std::size_t row = 0; row < t.size();)
+    {
+        if (t.object[row]->active)
+        {
+            ++row;
+            continue;
+        }
+        before(t.object[row]);
+        remove_row(t, row);
+    }
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+#include "types.hpp"
+#include "util/arena.hpp"
+#include "monster.hpp"
+#include "object_entity.hpp"
+
+/**
+ * Every entity on the floor besides the player, in one table per type. A table owns its
+ * objects and keeps dense columns of the fields per-frame queries read, so scanning the
+ * monsters walks a few flat arrays instead of casting and chasing pointers.
+ *
+ * Entities are named by generational handles into a slot array that maps to table rows, so
+ * adding and removing are O(1): a removed row is filled by the table's last one, which only
+ * changes that entity's slot. Row order is therefore not stable, handles and pointers are.
+ *
+ * The entities themselves live in the store's arena, so clearing the floor returns all of it at
+ * once and the next floor reuses the same memory. Their colors stay views of their descriptions,
+ * which outlive every floor, so spawning copies nothing.
+ *
+ * The columns mirror the objects: whoever changes a mirrored field calls sync() (GameContext
+ * does, from the hooks that see every move, hit and pickup).
+ */
+class EntityStore
+{
+public:
+    struct MonsterTable
+    {
+        std::vector<Monster *> object;
+        std::vector<mapsize_t> x, y;
+        std::vector<int> speed, health;
+        std::vector<Monster::Abilities> abilities;
+        std::vector<char> symbol;
+        std::vector<uint8_t> active;
+
+        std::size_t size() const { return object.size(); }
+        std::size_t alive() const; /**< Rows still active */
+    };
+
+    struct ObjectTable
+    {
+        std::vector<ObjectEntity *> object;
+        std::vector<mapsize_t> x, y;
+        std::vector<Object::Type> type;
+        std::vector<char> symbol;
+        std::vector<uint8_t> active;
+
+        std::size_t size() const { return object.size(); }
+    };
+
+    EntityStore() = default;
+    EntityStore(const EntityStore &) = delete;
+    EntityStore &operator=(const EntityStore &) = delete;
+    ~EntityStore() { clear(); }
+
+    /** Moves the entity into the store, where it stays put until removed. */
+    Monster *add(Monster m);
+    ObjectEntity *add(ObjectEntity o);
+
+    /** Destroys `e`, false if the store does not hold it. */
+    bool remove(Entity *e);
+
+    /** Destroys every inactive entity in one pass. `before` sees each one first. */
+    void remove_inactive(const std::function<void(Entity *)> &before);
+
+    void clear();
+    bool contains(const Entity *e) const;
+
+    /** The entity `h` names, nullptr once it has been removed. */
+    Entity *get(EntityHandle h) const;
+
+    /** Copies the mirrored fields of `e` back into its row. The player has no row. */
+    void sync(const Entity *e);
+
+    const MonsterTable &monsters() const { return monsters_; }
+    const ObjectTable &objects() const { return objects_; }
+    std::size_t size() const { return monsters_.size() + objects_.size(); }
+
+    /** f(Entity *) for every entity, monsters first. */
+    template <typename F>
+    void for_each(F &&f) const
+    {
+        for (const auto &m : monsters_.object)
+            f(static_cast<Entity *>(m));
+        for (const auto &o : objects_.object)
+            f(static_cast<Entity *>(o));
+    }
+
+private:
+    struct Slot
+    {
+        uint32_t generation = 0; /**< Bumped on removal, handles from before no longer match */
+        uint32_t row = 0;        /**< In the table of `kind` */
+        EntityKind kind = EntityKind::MONSTER;
+    };
+
+    // Hands `e` a slot pointing at `row`
+    void acquire_slot(Entity *e, std::size_t row);
+    void release_slot(const Entity *e);
+    std::size_t row_of(const Entity *e) const { return slots_[e->handle_.slot].row; }
+
+    // Row `from` replaces row `to`, whose entity is already destroyed
+    void move_row(MonsterTable &t, std::size_t from, std::size_t to);
+    void move_row(ObjectTable &t, std::size_t from, std::size_t to);
+    template <typename Table>
+    void resize(Table &t, std::size_t rows);
+    template <typename Table>
+    void remove_row(Table &t, std::size_t row);
+    void destroy(Monster *m) { monster_pool_.destroy(m); }
+    void destroy(ObjectEntity *o) { object_pool_.destroy(o); }
+    template <typename Table>
+    void remove_inactive(Table &t, const std::function<void(Entity *)> &before);
+
+    Arena arena_; // before the pools carved out of it
+    Pool<Monster> monster_pool_{arena_};
+    Pool<ObjectEntity> object_pool_{arena_};
+
+    MonsterTable monsters_;
+    ObjectTable objects_;
+    std::vector<Slot> slots_;
+    std::vector<uint32_t> free_slots_;
+};
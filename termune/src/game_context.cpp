@@ -8,23 +8,70 @@
 #include "object_parser.hpp"
 #include "util/fs.hpp"
 
+namespace // hide from other translation units
+{
+    // Small enough radii are looked up per cell instead of cast on every move
+    constexpr bool USE_FOV_TABLE = VISIBILITY_RADIUS <= ShadowCast::Table::MAX_RADIUS;
+
+    // Smaller batches of monster turns plan on the calling thread, larger ones in chunks of this
+    constexpr std::size_t PARALLEL_PLAN_MIN = 128;
+    constexpr std::size_t PLAN_GRAIN = 32;
+
+    // Monsters walk on the real map
+    struct OpenCost
+    {
+        const BitGrid *rock;
+
+        Pathing::cost_t operator()(std::size_t, std::size_t to) const
+        {
+            return rock->at(to % rock->width(), to / rock->width()) ? Pathing::UNREACHABLE : Pathing::cost_t(1);
+        }
+    };
+
+    // The player only plans through cells they have seen open (never seen is remembered as rock)
+    struct KnownCost
+    {
+        const Dungeon::cell_type_t *remembered;
+
+        Pathing::cost_t operator()(std::size_t, std::size_t to) const
+        {
+            return remembered[to] != Dungeon::CELL_ROCK ? Pathing::cost_t(1) : Pathing::UNREACHABLE;
+        }
+    };
+} // namespace
+
 GameContext::GameContext(Dungeon::Generator::Parameters params, mapsize_t width, mapsize_t height, unsigned int num_entities, int seed)
+    : GameContext(params, width, height, num_entities, {}, {}, seed)
+{
+    load_descriptions();
+}
+
+GameContext::GameContext(Dungeon::Generator::Parameters params, mapsize_t width, mapsize_t height, unsigned int num_entities,
+                         std::vector<MonsterDesc> monsters, std::vector<ObjectDesc> objects, int seed)
     : player(0, 0),
       dungeon(width, height),
       entity_map(width, height),
-      visibility_map(width, height, {Dungeon::CELL_ROCK, false}),
-      monster_tunneling_map(width, height, 0),
-      monster_nontunneling_map(width, height, 0),
+      visible_map(width, height),
+      explored_map(width, height),
+      sight_map(width, height),
+      remembered_map(width, height, Dungeon::CELL_ROCK),
       gen_params(params),
+      distance_maps(width, height),
+      monster_descs(std::move(monsters)),
+      object_descs(std::move(objects)),
       num_entities(num_entities),
       rng(seed == 0 ? std::random_device{}() : seed)
 {
-    load_descriptions();
+    item_goals.reset(width, height);
+    explore_goals.reset(width, height);
+    light_map.reset(width, height);
+    if (USE_FOV_TABLE)
+        fov_table.reset(width, height, VISIBILITY_RADIUS);
 }
 
 void GameContext::regenerate_dungeon()
 {
-    Dungeon::Generator::generate_dungeon(dungeon, gen_params, 0);
+    generator.generate_dungeon(dungeon, gen_params, 0);
     set_dungeon(dungeon, dungeon.rooms[0].center_x, dungeon.rooms[0].center_y);
 }
 
@@ -32,9 +79,12 @@ void GameContext::set_dungeon(Dungeon &d, mapsize_t pc_x, mapsize_t pc_y)
 {
     dungeon = d;
     entities.clear();
-    entity_map.fill({});
+    entity_map.clear();
     player.x = pc_x;
     player.y = pc_y;
+    entity_map.link(&player);
+    item_goals.reset(dungeon.width, dungeon.height);
+    light_map.reset(dungeon.width, dungeon.height);
 
     // Reset unique tracking for this floor
     spawned_uniques.clear();
@@ -43,155 +93,227 @@ void GameContext::set_dungeon(Dungeon &d, mapsize_t pc_x, mapsize_t pc_y)
         spawn_entity();
     }
 
-    events.flush();
+    flush_events();
     schedule_character_event(&player);
     for (auto *c : filter<Character>())
     {
         schedule_character_event(c);
     }
 
-    visibility_map.fill({Dungeon::CELL_ROCK, false});
+    visible_map.fill(false);
+    explored_map.fill(false);
+    sight_map.fill(false);
+    remembered_map.fill(Dungeon::CELL_ROCK);
+    if (USE_FOV_TABLE)
+        fov_table.reset(dungeon.width, dungeon.height, VISIBILITY_RADIUS);
+    explore_goals.reset(dungeon.width, dungeon.height);
+    distance_maps.invalidate();
     update_on_change();
 }
 
-void GameContext::add_entity(std::unique_ptr<Entity> e)
+Monster *GameContext::add_entity(Monster m)
+{
+    Monster *e = entities.add(std::move(m));
+    place_entity(e);
+    return e;
+}
+
+ObjectEntity *GameContext::add_entity(ObjectEntity o)
 {
-    Entity *raw = e.get();
-    entities.push_back(std::move(e));
+    ObjectEntity *e = entities.add(std::move(o));
+    place_entity(e);
+    return e;
+}
 
-    auto &list = entity_map.at(raw->x, raw->y);
-    auto it = std::find_if(list.begin(), list.end(), [&](Entity *other)
-                           { return raw->z < other->z; });
-    list.insert(it, raw);
+void GameContext::place_entity(Entity *e)
+{
+    entity_map.link(e);
+
+    if (e->as<ObjectEntity>())
+        update_on_item_change(e->x, e->y);
+    update_light_source(e);
 }
 
 void GameContext::remove_entity_from_map(Entity *e)
 {
-    auto &list = entity_map.at(e->x, e->y);
-    list.remove(e);
+    entity_map.unlink(e);
+    light_map.remove_source(e);
+    if (auto *c = e->as<Character>())
+        events.cancel(c->turn_event);
+
+    if (e->as<ObjectEntity>())
+        update_on_item_change(e->x, e->y);
 }
 
 void GameContext::remove_entity(Entity *e)
 {
-    auto it = std::find_if(entities.begin(), entities.end(),
-                           [&](const std::unique_ptr<Entity> &entity)
-                           { return entity.get() == e; });
-    if (it != entities.end())
-        entities.erase(it);
-    else
+    if (!entities.contains(e))
         return; // Entity not found
 
-    remove_entity_from_map(e);
+    remove_entity_from_map(e); // before erasing, e is gone after that
+    entities.remove(e);
 }
 
 void GameContext::clear_entities()
 {
     entities.clear();
-    entity_map.fill({});
+    entity_map.clear();
+    entity_map.link(&player);
+    item_goals.reset(dungeon.width, dungeon.height);
+    light_map.reset(dungeon.width, dungeon.height);
 }
 
 void GameContext::move_entity(Entity *e,
                               mapsize_t from_x, mapsize_t from_y,
                               mapsize_t to_x, mapsize_t to_y)
 {
-    entity_map.at(from_x, from_y).remove(e);
-
-    auto &list = entity_map.at(to_x, to_y);
-    auto it = std::find_if(list.begin(), list.end(), [&](Entity *other)
-                           { return e->z < other->z; });
-    list.insert(it, e);
-
+    entity_map.unlink(e); // from (from_x, from_y), where it stands
     e->x = to_x;
     e->y = to_y;
+    entity_map.link(e);
+    entities.sync(e);
+    update_light_source(e);
 }
 
 void GameContext::cleanup_dead_entities()
 {
-    for (auto it = entities.begin(); it != entities.end();)
-    {
-        if (!(*it)->active)
-        {
-            remove_entity_from_map(it->get());
-            it = entities.erase(it);
-        }
-        else
-        {
-            ++it;
-        }
-    }
+    entities.remove_inactive([&](Entity *e)
+                             { remove_entity_from_map(e); });
 }
 
-std::vector<Entity *> GameContext::entities_at(mapsize_t x, mapsize_t y) const
+EntityGrid::Range GameContext::entities_at(mapsize_t x, mapsize_t y) const
 {
-    std::vector<Entity *> result;
-    for (Entity *e : entity_map.at(x, y))
-    {
-        result.push_back(e);
-    }
-    return result;
+    return entity_map.at(x, y);
 }
 
 Entity *GameContext::top_entity_at(mapsize_t x, mapsize_t y) const
 {
-    auto &list = entity_map.at(x, y);
-    if (list.empty())
-        return nullptr;
-    return list.back();
+    return entity_map.top(x, y);
 }
 
-void GameContext::schedule_event(EventQueue::Callback cb, tick_t delay)
+void GameContext::schedule_character_event(Character *c)
 {
-    events.add(std::move(cb), delay);
+    if (!c || !c->active || events.scheduled(c->turn_event))
+        return;
+
+    c->turn_event = events.add(c, EVENT_CHARACTER_TURN, c->event_delay());
 }
 
-void GameContext::schedule_character_event(Character *c)
+bool GameContext::process_one_event()
 {
-    if (!c || !c->active)
-        return;
+    if (events.empty())
+        return true;
 
-    schedule_event(
-        [this, c]()
+    const auto event = events.pop();
+    switch (event.kind)
+    {
+    case EVENT_CHARACTER_TURN:
+        event.actor->turn_event = TurnQueue::NO_EVENT;
+        if (event.actor == &player)
+            return take_player_turn();
+
+        // Monsters due at the same tick take their turns together, up to the player's
+        turn_batch.assign(1, event.actor->as<Monster>());
+        while (const auto *next = events.due_now())
         {
-            bool is_player = c->as<Player>() != nullptr;
-
-            if (c->health <= 0)
-            {
-                c->active = false;
-                return is_player; // stop processing events
-            }
+            if (next->kind != EVENT_CHARACTER_TURN || next->actor == &player)
+                break;
+            Character *c = events.pop().actor;
+            c->turn_event = TurnQueue::NO_EVENT;
+            turn_batch.push_back(c->as<Monster>());
+        }
+        take_monster_turns();
+        return false;
+    }
+    return false;
+}
 
-            schedule_character_event(c);
+bool GameContext::take_player_turn()
+{
+    // Dead characters have no turns left, so the player is alive here
+    schedule_character_event(&player);
 
-            if (!c->active)
-                return false;
+    int dx = 0, dy = 0;
+    bool force = false;
+    player.move(dx, dy, *this, force);
+    if (!running)
+        return true;
+    update_on_change();
+    return true; // stop processing events
+}
 
-            int dx = 0, dy = 0;
-            bool force = false;
+void GameContext::take_monster_turns()
+{
+    // Planning only reads the map, the flow fields and the monster itself, so it can be split
+    // across threads; moves then go one at a time in queue order, whatever the thread count
+    const std::size_t count = turn_batch.size();
+    const std::size_t grain = count >= PARALLEL_PLAN_MIN ? PLAN_GRAIN : count;
+    turn_plans.assign(count, {});
+
+    // Workers only start once a batch is large enough to hand them anything
+    if (count >= PARALLEL_PLAN_MIN && decision_pool.workers() != decision_workers)
+        decision_pool.resize(decision_workers);
+
+    decision_pool.parallel_for(count, grain, [&](std::size_t begin, std::size_t end)
+                               {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            turn_batch[i]->update_sight(*this);
+            turn_plans[i].idle = turn_batch[i]->idle();
+        } });
 
-            if (is_player)
-            {
-                dx = dy = 0;
-                force = false;
-                c->move(dx, dy, *this, force);
-                if (!running)
-                    return true;
-                update_on_change();
-                return true; // stop processing events
-            }
-            else
-            {
-                c->as<Monster>()->get_desired_move(dx, dy, force, *this);
-                c->move(dx, dy, *this, force);
-                return false; // continue processing events
-            }
-        },
-        c->event_delay());
+    // Flow fields are brought up to date once, for whoever follows them
+    bool want_items = false, want_chase[2] = {false, false};
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const Monster *m = turn_batch[i];
+        if (turn_plans[i].idle || m->has(Monster::Abilities::ERRATIC))
+            continue;
+        want_items |= m->wants_item_flow();
+        want_chase[m->has(Monster::Abilities::TUNNELING)] |= m->wants_chase_flow();
+    }
+    const Pathing::FlowField *items = want_items ? &item_flow() : nullptr;
+    const Pathing::FlowField *walking = want_chase[0] ? &flow_field(DistanceMaps::Movement::WALKING) : nullptr;
+    const Pathing::FlowField *tunneling = want_chase[1] ? &flow_field(DistanceMaps::Movement::TUNNELING) : nullptr;
+
+    // Erratic monsters roll the dice in turn order, so the same seed gives the same game
+    decision_pool.parallel_for(count, grain, [&](std::size_t begin, std::size_t end)
+                               {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            const Monster *m = turn_batch[i];
+            TurnPlan &plan = turn_plans[i];
+            if (plan.idle || m->has(Monster::Abilities::ERRATIC))
+                continue;
+            MoveFlows flows{items, m->has(Monster::Abilities::TUNNELING) ? tunneling : walking};
+            plan.planned = m->plan_move(plan.dx, plan.dy, flows);
+        } });
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        Monster *m = turn_batch[i];
+        const TurnPlan &plan = turn_plans[i];
+
+        // An idle monster gets no next turn: seeing the player, a noise or a hit gives it one back
+        if (plan.idle || !m->active)
+            continue;
+
+        schedule_character_event(m);
+        int dx = plan.dx, dy = plan.dy;
+        bool force = false;
+        if (!plan.planned)
+            m->get_desired_move(dx, dy, force, *this);
+        m->move(dx, dy, *this, force);
+        if (!running) // the player died, nobody else moves
+            break;
+    }
 }
 
 void GameContext::run_turn()
 {
     cleanup_dead_entities();
-    events.process();
+    while (!process_one_event())
+        ;
 
     running = player.active;
     if (!running)
@@ -200,25 +322,84 @@ void GameContext::run_turn()
 
 void GameContext::process_events()
 {
-    while (running && !events.process_one())
+    while (running && !process_one_event())
         ;
 }
 
 void GameContext::flush_events()
 {
     events.flush();
+    player.turn_event = TurnQueue::NO_EVENT;
+    for (auto *c : filter<Character>())
+        c->turn_event = TurnQueue::NO_EVENT;
 }
 
 void GameContext::update_on_change()
 {
     update_visibility_map();
-    update_monster_tunneling_map();
-    update_monster_nontunneling_map();
 }
 
-VisibilityData &GameContext::visibility_at(mapsize_t x, mapsize_t y)
+const Grid<Pathing::cost_t> &GameContext::distance_map(DistanceMaps::Movement movement)
+{
+    return distance_maps.get(movement, dungeon, player.x, player.y);
+}
+
+Pathing::FlowField &GameContext::flow_field(DistanceMaps::Movement movement)
+{
+    return distance_maps.flow(movement, dungeon, player.x, player.y);
+}
+
+void GameContext::set_path_budget(std::chrono::microseconds budget)
+{
+    distance_maps.set_budget(budget);
+}
+
+void GameContext::advance_paths(std::chrono::microseconds budget)
+{
+    distance_maps.advance(dungeon, budget);
+}
+
+MoveFlows GameContext::move_flows(const Monster &m)
+{
+    MoveFlows flows;
+    if (m.wants_item_flow())
+        flows.items = &item_flow();
+    if (m.wants_chase_flow())
+        flows.chase = &flow_field(m.has(Monster::Abilities::TUNNELING) ? DistanceMaps::Movement::TUNNELING
+                                                                         : DistanceMaps::Movement::WALKING);
+    return flows;
+}
+
+void GameContext::set_decision_threads(std::size_t workers)
 {
-    return visibility_map.at(x, y);
+    decision_workers = workers;
+    if (decision_pool.workers() > 0) // already started, otherwise the first large batch starts them
+        decision_pool.resize(workers);
+}
+
+Pathing::FlowField &GameContext::item_flow()
+{
+    return item_goals.flow(OpenCost{&dungeon.rock_grid});
+}
+
+Pathing::FlowField &GameContext::explore_flow()
+{
+    return explore_goals.flow(KnownCost{remembered_map.data()});
+}
+
+VisibilityData GameContext::visibility_at(mapsize_t x, mapsize_t y) const
+{
+    return {remembered_map.at(x, y), visible_map.at(x, y), explored_map.at(x, y)};
+}
+
+bool GameContext::sees_player(mapsize_t x, mapsize_t y) const
+{
+    return sight_map.at(x, y);
+}
+
+Lighting::level_t GameContext::light_at(mapsize_t x, mapsize_t y) const
+{
+    return light_map.at(x, y);
 }
 
 void GameContext::quit()
@@ -242,94 +423,201 @@ void GameContext::load_descriptions()
     object_descs = std::move(ObjectParser::load_from_file(object_path));
 }
 
-namespace // hide from other translation units
+void GameContext::update_visibility_map()
 {
-    class DistanceNode : public Pathing::Node
+    // Nothing outside the last windows was visible
+    const ShadowCast::Window &last = fov_workspace.window;
+    for (std::size_t y = last.min_y; y < last.max_y; ++y)
+        visible_map.fill_span(y, last.min_x, last.max_x, false);
+    const ShadowCast::Window &last_sight = sight_workspace.window;
+    for (std::size_t y = last_sight.min_y; y < last_sight.max_y; ++y)
+        sight_map.fill_span(y, last_sight.min_x, last_sight.max_x, false);
+    const ShadowCast::Window &last_lit = lit_workspace.window;
+    for (std::size_t y = last_lit.min_y; y < last_lit.max_y; ++y)
+        visible_map.fill_span(y, last_lit.min_x, last_lit.max_x, false);
+
+    update_light_source(&player); // equipment can change between moves
+    light_map.update(dungeon.rock_grid);
+
+    learned_cells.clear();
+    auto see = [&](std::size_t x, std::size_t y)
     {
-    public:
-        mapsize_t x, y;
-        Grid<Dungeon::cell_hardness_t> *weights;
-        mapsize_t w, h;
+        visible_map.set(x, y);
+
+        Dungeon::cell_type_t type = dungeon.type_grid.at(x, y);
+        Dungeon::cell_type_t &last_seen = remembered_map.at(x, y);
+        if (!explored_map.at(x, y) || (last_seen == Dungeon::CELL_ROCK) != (type == Dungeon::CELL_ROCK))
+            learned_cells.push_back(x + y * dungeon.width);
+        last_seen = type;
+        explored_map.set(x, y);
+    };
 
-        DistanceNode(mapsize_t x, mapsize_t y, Grid<Dungeon::cell_hardness_t> *map)
-            : x(x), y(y), weights(map), w(map->width()), h(map->height()) {}
+    if (USE_FOV_TABLE)
+        fov_table.cast(dungeon.rock_grid, player.x, player.y, fov_workspace, see);
+    else
+        ShadowCast::cast(dungeon.rock_grid, player.x, player.y, VISIBILITY_RADIUS, fov_workspace, see);
+
+    // One symmetric cast answers every monster: it reaches a monster exactly when a cast from
+    // the monster would reach the player
+    ShadowCast::cast_symmetric(dungeon.rock_grid, player.x, player.y, MONSTER_SIGHT_RADIUS, sight_workspace,
+                               [&](std::size_t x, std::size_t y)
+                               {
+                                   sight_map.set(x, y);
+                                   wake_monsters_at(x, y); // they see the player now
+                               });
+
+    // Lit cells are seen from further away, as long as nothing is in between
+    if (light_map.source_count() > 0)
+        ShadowCast::cast(dungeon.rock_grid, player.x, player.y, LIT_SIGHT_RADIUS, lit_workspace,
+                         [&](std::size_t x, std::size_t y)
+                         {
+                             if (light_map.lit(x, y))
+                                 see(x, y);
+                         });
+    else
+        lit_workspace.window = {};
 
-        std::vector<std::size_t> get_neighbors() const override
-        {
-            std::vector<std::size_t> neighbors;
-            for (int dy = -1; dy <= 1; dy++)
-            {
-                for (int dx = -1; dx <= 1; dx++)
-                {
-                    if (dx == 0 && dy == 0)
-                        continue;
-                    mapsize_t nx = x + dx, ny = y + dy;
-                    if (nx < w && ny < h && weights->at(nx, ny) < 255)
-                        neighbors.push_back(ny * w + nx);
-                }
-            }
-            return neighbors;
-        }
+    update_explore_goals();
+}
 
-        unsigned long movement_cost_to(const Node &n) const override
-        {
-            const auto &other = static_cast<const DistanceNode &>(n);
-            return 1 + weights->at(other.x, other.y) / 85;
-        }
+void GameContext::update_light_source(Entity *e)
+{
+    Lighting::Source source{e->x, e->y, 0, 0};
+    if (e == &player)
+    {
+        if (player.equipment[Player::LIGHT_SLOT].is(Object::TYPE_LIGHT))
+            source = {e->x, e->y, LIGHT_ITEM_RADIUS, LIGHT_ITEM_BRIGHTNESS};
+    }
+    else if (const auto *o = e->as<ObjectEntity>())
+    {
+        if (o->is(Object::TYPE_LIGHT))
+            source = {e->x, e->y, LIGHT_ITEM_RADIUS, LIGHT_ITEM_BRIGHTNESS};
+    }
+    else if (const auto *m = e->as<Monster>())
+    {
+        if (m->has(Monster::Abilities::GLOW))
+            source = {e->x, e->y, GLOW_RADIUS, GLOW_BRIGHTNESS};
+    }
 
-        bool is_goal() const override { return false; }
-    };
-} // namespace
+    if (e->active && source.radius > 0)
+        light_map.set_source(e, source);
+    else
+        light_map.remove_source(e);
+}
 
-void GameContext::update_visibility_map()
+void GameContext::update_explore_goals()
 {
-    ShadowCast::Lightmap solid(dungeon.width, dungeon.height);
-    for (mapsize_t y = 0; y < dungeon.height; ++y)
-        for (mapsize_t x = 0; x < dungeon.width; ++x)
-            solid.at(x, y) = dungeon.type_grid.at(x, y) == Dungeon::CELL_ROCK;
+    KnownCost cost{remembered_map.data()};
 
-    auto lightmap = ShadowCast::solve_lightmap(solid, player.x, player.y, VISIBILITY_RADIUS);
-    for (mapsize_t y = 0; y < dungeon.height; ++y)
-        for (mapsize_t x = 0; x < dungeon.width; ++x)
+    // Newly known open cells first, so goal changes below repair against the final costs
+    for (std::size_t idx : learned_cells)
+        explore_goals.cost_decreased(idx, cost);
+
+    // A learned cell can stop its neighbors from being an edge, or become one itself
+    for (std::size_t idx : learned_cells)
+    {
+        mapsize_t x = idx % dungeon.width, y = idx / dungeon.width;
+        for (int dy = -1; dy <= 1; ++dy)
+            for (int dx = -1; dx <= 1; ++dx)
+            {
+                mapsize_t nx = x + dx, ny = y + dy;
+                if (dungeon.in_bounds(nx, ny))
+                    explore_goals.set_goal(nx + ny * dungeon.width, is_explore_edge(nx, ny), cost);
+            }
+    }
+}
+
+bool GameContext::is_explore_edge(mapsize_t x, mapsize_t y) const
+{
+    if (remembered_map.at(x, y) == Dungeon::CELL_ROCK) // also every cell never seen
+        return false;
+
+    for (int dy = -1; dy <= 1; ++dy)
+        for (int dx = -1; dx <= 1; ++dx)
         {
-            visibility_map.at(x, y).visible = lightmap.at(x, y);
-            if (lightmap.at(x, y))
-                visibility_map.at(x, y).last_seen = dungeon.type_grid.at(x, y);
+            mapsize_t nx = x + dx, ny = y + dy;
+            if (dungeon.in_bounds(nx, ny) && !explored_map.at(nx, ny))
+                return true;
         }
+    return false;
 }
 
-void GameContext::update_monster_tunneling_map()
+void GameContext::update_on_terrain_change(mapsize_t x, mapsize_t y)
 {
-    auto &weights = dungeon.hardness_grid;
+    distance_maps.terrain_changed(x, y);
 
-    std::vector<std::unique_ptr<Pathing::Node>> nodes;
-    for (mapsize_t y = 0; y < dungeon.height; ++y)
-        for (mapsize_t x = 0; x < dungeon.width; ++x)
-            nodes.push_back(std::make_unique<DistanceNode>(x, y, &weights));
+    if (dungeon.type_grid.at(x, y) != Dungeon::CELL_ROCK)
+    {
+        item_goals.cost_decreased(x + y * dungeon.width, OpenCost{&dungeon.rock_grid});
+        if (USE_FOV_TABLE)
+            fov_table.cell_changed(x, y);
+        light_map.cell_changed(x, y);
+        update_visibility_map(); // an opened cell can reveal what is behind it
+    }
+}
 
-    std::size_t start = player.x + player.y * dungeon.width;
-    Pathing::solve(nodes, start);
+void GameContext::update_on_damage(Entity *e)
+{
+    if (auto *c = e->as<Character>())
+    {
+        if (c->health > 0)
+        {
+            schedule_character_event(c); // hurt monsters wake up
+        }
+        else
+        {
+            c->active = false;
+            events.cancel(c->turn_event);
+            if (c == &player)
+                running = false;
+        }
+    }
+    entities.sync(e); // health, and whether it is still alive
+}
 
-    for (std::size_t i = 0; i < nodes.size(); ++i)
-        monster_tunneling_map(i % dungeon.width, i / dungeon.width) = static_cast<uint32_t>(nodes[i]->cost);
+void GameContext::make_noise(mapsize_t x, mapsize_t y, mapsize_t radius)
+{
+    const mapsize_t min_x = x - std::min(x, radius), max_x = std::min<int>(dungeon.width - 1, x + radius);
+    const mapsize_t min_y = y - std::min(y, radius), max_y = std::min<int>(dungeon.height - 1, y + radius);
+    for (mapsize_t cy = min_y; cy <= max_y; ++cy)
+        for (mapsize_t cx = min_x; cx <= max_x; ++cx)
+            wake_monsters_at(cx, cy);
 }
 
-void GameContext::update_monster_nontunneling_map()
+void GameContext::wake_monsters_at(mapsize_t x, mapsize_t y)
 {
-    Grid<Dungeon::cell_hardness_t> weights(dungeon.width, dungeon.height);
+    for (Entity *e : entity_map.at(x, y))
+        if (auto *m = e->as<Monster>())
+            schedule_character_event(m); // a no-op for monsters that are awake
+}
 
-    for (mapsize_t y = 0; y < dungeon.height; ++y)
-        for (mapsize_t x = 0; x < dungeon.width; ++x)
-            weights.at(x, y) = dungeon.type_grid(x, y) == Dungeon::CELL_ROCK ? 255 : 0;
+void GameContext::update_on_item_change(mapsize_t x, mapsize_t y)
+{
+    const auto list = entity_map.at(x, y);
+    for (Entity *e : list)
+        if (e->as<ObjectEntity>())
+        {
+            entities.sync(e);
+            update_light_source(e); // a light picked up goes out
+        }
+    bool has_item = std::any_of(list.begin(), list.end(), [](const Entity *e)
+                                { return e->active && e->as<ObjectEntity>(); });
+    item_goals.set_goal(x + y * dungeon.width, has_item, OpenCost{&dungeon.rock_grid});
+}
 
-    std::vector<std::unique_ptr<Pathing::Node>> nodes;
-    for (mapsize_t y = 0; y < dungeon.height; ++y)
-        for (mapsize_t x = 0; x < dungeon.width; ++x)
-            nodes.push_back(std::make_unique<DistanceNode>(x, y, &weights));
+bool GameContext::step_towards(mapsize_t from_x, mapsize_t from_y,
+                               mapsize_t to_x, mapsize_t to_y,
+                               int &dx, int &dy)
+{
+    if (!dungeon.in_bounds(to_x, to_y))
+        return false;
 
-    std::size_t start = player.x + player.y * dungeon.width;
-    Pathing::solve(nodes, start);
+    std::size_t start = from_x + from_y * dungeon.width;
+    std::size_t goal = to_x + to_y * dungeon.width;
+    if (!jps.find_path(dungeon.rock_grid, start, goal, path_scratch) || path_scratch.size() < 2)
+        return false;
 
-    for (std::size_t i = 0; i < nodes.size(); ++i)
-        monster_nontunneling_map(i % dungeon.width, i / dungeon.width) = static_cast<uint32_t>(nodes[i]->cost);
+    dx = static_cast<int>(path_scratch[1] % dungeon.width) - from_x;
+    dy = static_cast<int>(path_scratch[1] / dungeon.width) - from_y;
+    return true;
 }
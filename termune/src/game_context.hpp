@@ -2,53 +2,114 @@
 
 #include <vector>
 #include <memory>
-#include <list>
 #include <functional>
 #include <random>
 
 #include "entity.hpp"
+#include "entity_store.hpp"
+#include "entity_grid.hpp"
 #include "player.hpp"
 #include "dungeon.hpp"
-#include "util/event_queue.hpp"
+#include "distance_maps.hpp"
 #include "util/shadowcast.hpp"
 #include "util/grid.hpp"
-#include "util/filtered_view.hpp"
+#include "util/bit_grid.hpp"
+#include "util/pathing.hpp"
+#include "util/jps.hpp"
+#include "util/goal_map.hpp"
+#include "util/lighting.hpp"
+#include "util/thread_pool.hpp"
 #include "monster_parser.hpp"
 #include "object_parser.hpp"
 
 static constexpr mapsize_t VISIBILITY_RADIUS = 3;
+static constexpr mapsize_t MONSTER_SIGHT_RADIUS = 3; // how far monsters see the player from
 
+// How far sleeping monsters hear a fight, or rock giving way to a tunneler
+static constexpr mapsize_t COMBAT_NOISE_RADIUS = 6;
+static constexpr mapsize_t DIG_NOISE_RADIUS = 4;
+
+// Light sources, and how far away the player still sees cells they light
+static constexpr mapsize_t LIGHT_ITEM_RADIUS = 5; // carried or on the floor
+static constexpr mapsize_t GLOW_RADIUS = 2;       // monsters with the GLOW ability
+static constexpr mapsize_t LIT_SIGHT_RADIUS = 20;
+static constexpr Lighting::level_t LIGHT_ITEM_BRIGHTNESS = 200;
+static constexpr Lighting::level_t GLOW_BRIGHTNESS = 100;
+
+// What the player knows about one cell, gathered from GameContext's visibility layers
 struct VisibilityData
 {
     Dungeon::cell_type_t last_seen;
     bool visible;
+    bool explored; // seen at least once, last_seen is meaningful
 };
 
 class GameContext
 {
 public:
     GameContext(Dungeon::Generator::Parameters params, mapsize_t width, mapsize_t height, unsigned int num_entities, int seed = 0);
+    // Same, with the descriptions given instead of loaded from ~/.rlg327
+    GameContext(Dungeon::Generator::Parameters params, mapsize_t width, mapsize_t height, unsigned int num_entities,
+                std::vector<MonsterDesc> monsters, std::vector<ObjectDesc> objects, int seed = 0);
 
     void regenerate_dungeon();
     void set_dungeon(Dungeon &d, mapsize_t pc_x, mapsize_t pc_y);
 
-    void add_entity(std::unique_ptr<Entity> e);
+    Monster *add_entity(Monster m);
+    ObjectEntity *add_entity(ObjectEntity o);
     void remove_entity(Entity *e);
     void move_entity(Entity *e,
                      mapsize_t from_x, mapsize_t from_y,
                      mapsize_t to_x, mapsize_t to_y);
     void clear_entities();
 
-    std::vector<Entity *> entities_at(mapsize_t x, mapsize_t y) const;
+    // Top first. The range walks the cell's live chain: linking, unlinking or moving an
+    // occupant while iterating breaks it, so copy the occupants out first if callbacks might
+    EntityGrid::Range entities_at(mapsize_t x, mapsize_t y) const;
     Entity *top_entity_at(mapsize_t x, mapsize_t y) const;
 
-    void schedule_event(EventQueue::Callback cb, tick_t delay);
     void process_events();
     void flush_events();
 
     void update_on_change();
+    void update_on_terrain_change(mapsize_t x, mapsize_t y);
+    void update_on_item_change(mapsize_t x, mapsize_t y);
+    void update_on_damage(Entity *e); // a character out of health dies and loses its turns, others wake
+
+    // Wakes the idle monsters within `radius` of (x, y)
+    void make_noise(mapsize_t x, mapsize_t y, mapsize_t radius);
+
+    // Distance map towards the player, computed on demand
+    const Grid<Pathing::cost_t> &distance_map(DistanceMaps::Movement movement);
+    Pathing::FlowField &flow_field(DistanceMaps::Movement movement);
+
+    // Spread distance map recomputes over frames: at most `budget` per request, the rest in idle time
+    void set_path_budget(std::chrono::microseconds budget);
+    void advance_paths(std::chrono::microseconds budget);
+
+    // Walking towards the nearest item, and (over explored cells only) the nearest unexplored edge
+    Pathing::FlowField &item_flow();
+    Pathing::FlowField &explore_flow();
+
+    // The flow fields Monster::plan_move() reads for `m`, brought up to date
+    MoveFlows move_flows(const Monster &m);
 
-    VisibilityData &visibility_at(mapsize_t x, mapsize_t y);
+    // Threads besides the caller that plan monster moves, a spare hardware thread each by default.
+    // They are started by the first batch of monster turns large enough to split.
+    void set_decision_threads(std::size_t workers);
+
+    // First step of a shortest walking (non-tunneling) path, false if there is none
+    bool step_towards(mapsize_t from_x, mapsize_t from_y,
+                      mapsize_t to_x, mapsize_t to_y,
+                      int &dx, int &dy);
+
+    VisibilityData visibility_at(mapsize_t x, mapsize_t y) const;
+
+    // Whether a monster at (x, y) sees the player, one lookup into a symmetric cast from the player
+    bool sees_player(mapsize_t x, mapsize_t y) const;
+
+    // Light from every source on the floor, as of the last visibility update
+    Lighting::level_t light_at(mapsize_t x, mapsize_t y) const;
     void quit();
     tick_t current_tick() const;
 
@@ -56,23 +117,29 @@ public:
     std::vector<T *> filter(F &&pred = [](const T &)
                             { return true; }) const;
 
-    template <typename T>
-    auto filtered(std::function<bool(const T &)> pred = [](const T &)
-                  { return true; }) const
-    {
-        return FilteredView<T, std::vector<std::unique_ptr<Entity>>>(entities, pred);
-    }
-
     void schedule_character_event(Character *c);
     void run_turn();
 
 private:
-    void cleanup_dead_entities();
+    enum EventKind : uint8_t
+    {
+        EVENT_CHARACTER_TURN,
+    };
+
+    // Runs the earliest event, true when the queue should stop for the player
+    bool process_one_event();
+    bool take_player_turn();
+    void take_monster_turns(); // every monster in turn_batch
+    void wake_monsters_at(mapsize_t x, mapsize_t y);
+
+    void cleanup_dead_entities(); // once per turn, every entity that died in it in one pass
 
     void update_visibility_map();
-    void update_monster_tunneling_map();
-    void update_monster_nontunneling_map();
+    void update_light_source(Entity *e);
+    void update_explore_goals();
+    bool is_explore_edge(mapsize_t x, mapsize_t y) const;
 
+    void place_entity(Entity *e); // on the map, once the store holds it
     void remove_entity_from_map(Entity *e);
 
     void load_descriptions();
@@ -82,18 +149,48 @@ private:
 public:
     Player player;
     Dungeon dungeon;
-    std::vector<std::unique_ptr<Entity>> entities;
+    EntityStore entities; // everything on the floor but the player
 
 public:
     bool running = true;
-    Grid<std::list<Entity *>> entity_map;
-    Grid<VisibilityData> visibility_map;
-    Grid<unsigned int> monster_tunneling_map;
-    Grid<unsigned int> monster_nontunneling_map;
+    EntityGrid entity_map; // the player too
+
+    // Player's view of the map, one layer per field of VisibilityData
+    BitGrid visible_map;                       // in the player's FOV right now
+    BitGrid explored_map;                      // seen at least once
+    BitGrid sight_map;                         // monsters here see the player, from a symmetric cast
+    Grid<Dungeon::cell_type_t> remembered_map; // as last seen, rock where never seen
 
 private:
-    EventQueue events;
+    TurnQueue events;
+
+    // Monsters whose turns are due at the same tick, in queue order, and what they plan to do
+    struct TurnPlan
+    {
+        int dx = 0, dy = 0;
+        bool idle = false;
+        bool planned = false; // dx, dy are set, otherwise get_desired_move() decides in turn order
+    };
+    std::vector<Monster *> turn_batch;
+    std::vector<TurnPlan> turn_plans;
+    ThreadPool decision_pool;
+    std::size_t decision_workers = ThreadPool::spare_threads(); // what decision_pool grows to once started
     Dungeon::Generator::Parameters gen_params;
+    Dungeon::Generator generator;
+
+    DistanceMaps distance_maps;
+
+    ShadowCast::Workspace fov_workspace;   // player's FOV, visible_map is only set inside its window
+    ShadowCast::Workspace sight_workspace; // symmetric cast from the player, sight_map is only set inside its window
+    ShadowCast::Table fov_table;           // FOV from every cell the player stood on, for small radii
+    ShadowCast::Workspace lit_workspace;   // lit cells the player sees beyond their own FOV
+    Lighting::LightMap light_map;          // keyed by the Entity giving off the light
+    Pathing::JumpPointSearch jps;
+    std::vector<std::size_t> path_scratch;
+
+    Pathing::GoalMap item_goals;    // goals: cells with an item on the floor
+    Pathing::GoalMap explore_goals; // goals: explored open cells next to unexplored ones
+    std::vector<std::size_t> learned_cells;
 
     std::vector<MonsterDesc> monster_descs;
     std::vector<ObjectDesc> object_descs;
@@ -111,16 +208,11 @@ template <typename T, typename F>
 std::vector<T *> GameContext::filter(F &&pred) const
 {
     std::vector<T *> result;
-    for (const auto &e : entities)
-    {
-        if (auto *casted = e.get()->as<T>())
-        {
+    entities.for_each([&](Entity *e)
+                      {
+        if (auto *casted = e->as<T>())
             if (pred(*casted))
-            {
-                result.push_back(casted);
-            }
-        }
-    }
+                result.push_back(casted); });
     return result;
 }
 
@@ -151,8 +243,7 @@ inline void GameContext::spawn_entity()
             } while (dungeon.type_grid.at(x, y) == Dungeon::CELL_ROCK ||
                      top_entity_at(x, y) != nullptr);
 
-            auto monster = desc.make_instance(x, y, rng);
-            add_entity(std::move(monster));
+            add_entity(desc.make_instance(x, y, rng));
 
             if (desc.has_ability(Monster::Abilities::UNIQUE))
                 spawned_uniques.insert(&desc);
@@ -180,8 +271,7 @@ inline void GameContext::spawn_entity()
             } while (dungeon.type_grid.at(x, y) == Dungeon::CELL_ROCK ||
                      top_entity_at(x, y) != nullptr);
 
-            auto object = desc.make_instance(x, y, rng);
-            add_entity(std::move(object));
+            add_entity(desc.make_instance(x, y, rng));
             return;
         }
     }
@@ -3,12 +3,13 @@
 #include <cmath>
 #include <random>
 #include <limits>
+#include <algorithm>
 
 #include "util/noise.hpp"
 #include "util/pathing.hpp"
 #include "util/img_proc.hpp"
 
-void Dungeon::Generator::generate_dungeon(Dungeon &dungeon, const Parameters &params, int seed = 0)
+void Dungeon::Generator::generate_dungeon(Dungeon &dungeon, const Parameters &params, int seed, Stats *stats)
 {
     constexpr std::size_t BUCKET_SIZE = 256;
 
@@ -178,56 +179,47 @@ void Dungeon::Generator::generate_dungeon(Dungeon &dungeon, const Parameters &pa
         }
     }
 
-    // Corridor generation
+    // Corridor generation: A* between consecutive rooms over rock hardness. Open cells cost
+    // as much as the softest rock, so Manhattan distance scaled by that minimum never
+    // overestimates and the search heads straight for the goal room.
+    cell_hardness_t min_step = 255;
+    for (mapsize_t y = 0; y < dungeon.height; ++y)
+        for (mapsize_t x = 0; x < dungeon.width; ++x)
+            if (dungeon.type_grid.at(x, y) == CELL_ROCK)
+                min_step = std::min(min_step, dungeon.hardness_grid.at(x, y));
+
+    if (corridor_cost.width() != dungeon.width || corridor_cost.height() != dungeon.height)
+        corridor_cost = Grid<Pathing::cost_t>(dungeon.width, dungeon.height);
+
     for (std::size_t i = 0; i < dungeon.rooms.size(); ++i)
     {
         const auto &start = dungeon.rooms[i];
         const auto &end = dungeon.rooms[(i + 1) % dungeon.rooms.size()];
 
-        struct DungeonNode : public Pathing::Node
-        {
-            mapsize_t x, y;
-            Grid<cell_hardness_t> *hardness_grid;
-            mapsize_t goal_x, goal_y;
-
-            DungeonNode(mapsize_t x, mapsize_t y, Grid<cell_hardness_t> *g, mapsize_t gx, mapsize_t gy)
-                : x(x), y(y), hardness_grid(g), goal_x(gx), goal_y(gy) {}
-
-            std::vector<std::size_t> get_neighbors() const override
-            {
-                std::vector<std::size_t> n;
-                if (static_cast<std::size_t>(x) > 0)
-                    n.push_back(y * hardness_grid->width() + (x - 1));
-                if (static_cast<std::size_t>(x + 1) < hardness_grid->width())
-                    n.push_back(y * hardness_grid->width() + (x + 1));
-                if (static_cast<std::size_t>(y) > 0)
-                    n.push_back((y - 1) * hardness_grid->width() + x);
-                if (static_cast<std::size_t>(y + 1) < hardness_grid->height())
-                    n.push_back((y + 1) * hardness_grid->width() + x);
-                return n;
-            }
-
-            uint64_t movement_cost_to(const Node &neighbor) const override
-            {
-                auto &n = static_cast<const DungeonNode &>(neighbor);
-                return hardness_grid->at(n.x, n.y);
-            }
+        const cell_hardness_t *hardness = dungeon.hardness_grid.data();
+        const std::size_t width = dungeon.width;
+        const std::size_t start_idx = start.center_y * width + start.center_x;
+        const std::size_t goal_idx = end.center_y * width + end.center_x;
 
-            bool is_goal() const override
+        std::size_t goal = Pathing::solve_astar<Pathing::Connectivity::FOUR>(
+            workspace, corridor_cost, start_idx, goal_idx,
+            [hardness, min_step](std::size_t, std::size_t to)
+            { return static_cast<Pathing::cost_t>(std::max(hardness[to], min_step)); },
+            [width, goal_idx, min_step](std::size_t idx)
             {
-                return x == goal_x && y == goal_y;
-            }
-        };
-
-        std::vector<std::unique_ptr<Pathing::Node>> nodes;
-        for (mapsize_t y = 0; y < dungeon.height; ++y)
-            for (mapsize_t x = 0; x < dungeon.width; ++x)
-                nodes.emplace_back(std::make_unique<DungeonNode>(x, y,
-                                                                 &dungeon.hardness_grid,
-                                                                 end.center_x, end.center_y));
-
-        size_t start_idx = start.center_y * dungeon.width + start.center_x;
-        auto path = Pathing::solve(nodes, start_idx);
+                std::size_t dx = idx % width > goal_idx % width ? idx % width - goal_idx % width
+                                                                : goal_idx % width - idx % width;
+                std::size_t dy = idx / width > goal_idx / width ? idx / width - goal_idx / width
+                                                                : goal_idx / width - idx / width;
+                return static_cast<Pathing::cost_t>((dx + dy) * min_step);
+            });
+        Pathing::trace_path(workspace, goal, path);
+
+        if (stats)
+        {
+            ++stats->corridor_searches;
+            stats->corridor_expansions += workspace.expanded;
+        }
 
         for (size_t idx : path)
         {
@@ -258,4 +250,6 @@ void Dungeon::Generator::generate_dungeon(Dungeon &dungeon, const Parameters &pa
         dungeon.hardness_grid.at(x, y) = 0;
         stair_dir ^= 1;
     }
+
+    dungeon.update_rock_grid();
 }
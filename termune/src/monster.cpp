@@ -17,9 +17,9 @@ void Monster::on_collision(Entity &other)
     }
 }
 
-void Monster::update_sight(mapsize_t x, mapsize_t y, GameContext &g)
+void Monster::update_sight(const GameContext &g)
 {
-    has_line_of_sight = g.visibility_at(x, y).visible;
+    has_line_of_sight = g.sees_player(x, y);
     if (has_line_of_sight)
     {
         target_x = g.player.x;
@@ -27,6 +27,16 @@ void Monster::update_sight(mapsize_t x, mapsize_t y, GameContext &g)
     }
 }
 
+bool Monster::idle() const
+{
+    if (has_line_of_sight || has(Abilities::ERRATIC) || has(Abilities::TELEPATHIC) ||
+        has(Abilities::PICKUP) || has(Abilities::DESTROY))
+        return false;
+
+    // Smart ones still walk to where they last saw the player
+    return !has(Abilities::INTELLIGENT) || target_x == EMPTY_TARGET || (target_x == x && target_y == y);
+}
+
 void Monster::get_desired_move(int &dx, int &dy, bool &force, GameContext &g) const
 {
     force = false;
@@ -39,62 +49,62 @@ void Monster::get_desired_move(int &dx, int &dy, bool &force, GameContext &g) co
         return;
     }
 
-    if (has_line_of_sight && target_x != EMPTY_TARGET && target_y != EMPTY_TARGET)
+    if (plan_move(dx, dy, g.move_flows(*this)))
+        return;
+
+    // Walkers route around rock to the remembered spot
+    if (g.step_towards(x, y, target_x, target_y, dx, dy))
+        return;
+    dx = (target_x == x ? 0 : (target_x > x ? 1 : -1));
+    dy = (target_y == y ? 0 : (target_y > y ? 1 : -1));
+}
+
+bool Monster::plan_move(int &dx, int &dy, const MoveFlows &flows) const
+{
+    dx = dy = 0;
+
+    if (chasing())
     {
         dx = (target_x == x ? 0 : (target_x > x ? 1 : -1));
         dy = (target_y == y ? 0 : (target_y > y ? 1 : -1));
-        return;
+        return true;
     }
 
+    // Out of sight of the player, item hunters head for the nearest item
+    if (wants_item_flow() && flows.items->step(x, y, dx, dy))
+        return true;
+
     if (has(Abilities::INTELLIGENT) && has(Abilities::TELEPATHIC))
     {
-        const auto &dist_map = has(Abilities::TUNNELING) ? g.monster_tunneling_map : g.monster_nontunneling_map;
-
-        mapsize_t best_x = x, best_y = y;
-        uint32_t best_cost = dist_map(x, y);
-        int start = rand() % 8;
-        const int offsets[8][2] = {
-            {-1, -1}, {0, -1}, {1, -1}, {-1, 0}, {1, 0}, {-1, 1}, {0, 1}, {1, 1}};
-
-        for (int i = 0; i < 8; ++i)
-        {
-            auto nx = static_cast<std::size_t>(x + offsets[(start + i) % 8][0]);
-            auto ny = static_cast<std::size_t>(y + offsets[(start + i) % 8][1]);
-            if (nx >= dist_map.width() || ny >= dist_map.height())
-                continue;
-            uint32_t cost = dist_map(nx, ny);
-            if (cost < best_cost)
-            {
-                best_cost = cost;
-                best_x = nx;
-                best_y = ny;
-            }
-        }
-
-        dx = static_cast<int>(best_x) - static_cast<int>(x);
-        dy = static_cast<int>(best_y) - static_cast<int>(y);
-        return;
+        // The flow field points every cell one step down the distance map
+        flows.chase->step(x, y, dx, dy);
+        return true;
     }
 
     if (has(Abilities::INTELLIGENT) && !has(Abilities::TELEPATHIC))
     {
         if (target_x != EMPTY_TARGET && target_y != EMPTY_TARGET)
         {
+            // Walkers need a path search, tunnelers dig straight at the remembered spot
+            if (!has(Abilities::TUNNELING))
+                return false;
+
             dx = (target_x == x ? 0 : (target_x > x ? 1 : -1));
             dy = (target_y == y ? 0 : (target_y > y ? 1 : -1));
         }
-        return;
+        return true;
     }
 
     if (!has(Abilities::INTELLIGENT) && has(Abilities::TELEPATHIC))
     {
         dx = (target_x == x ? 0 : (target_x > x ? 1 : -1));
         dy = (target_y == y ? 0 : (target_y > y ? 1 : -1));
-        return;
+        return true;
     }
 
-    dx = dy = 0;
+    return true;
 }
+
 bool Monster::move(int dx, int dy, GameContext &g, bool force)
 {
     mapsize_t nx = x + dx;
@@ -114,14 +124,15 @@ bool Monster::move(int dx, int dy, GameContext &g, bool force)
         int new_hardness = hardness - 85;
         if (new_hardness <= 0)
         {
-            g.dungeon.type_grid(nx, ny) = Dungeon::CELL_CORRIDOR;
+            g.dungeon.set_type(nx, ny, Dungeon::CELL_CORRIDOR);
             g.dungeon.hardness_grid(nx, ny) = 0;
-            g.update_on_change(); // update visibility and distance maps
+            g.update_on_terrain_change(nx, ny); // update visibility and distance maps
+            g.make_noise(nx, ny, DIG_NOISE_RADIUS);
         }
         else
         {
             g.dungeon.hardness_grid(nx, ny) = new_hardness;
-            g.update_on_change(); // update visibility and distance maps
+            g.update_on_terrain_change(nx, ny); // update distance maps
             return true;          // did some mining but not enough to pass through
         }
     }
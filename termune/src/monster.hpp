@@ -3,9 +3,17 @@
 #include <limits>
 
 #include "character.hpp"
+#include "util/flow_field.hpp"
 
 constexpr int MONSTER_ZINDEX = 2; // Above items, below player
 
+// The flow fields Monster::plan_move() follows, null where the monster was not going to need one
+struct MoveFlows
+{
+    const Pathing::FlowField *items = nullptr; // towards the nearest item
+    const Pathing::FlowField *chase = nullptr; // towards the player, for the monster's own movement
+};
+
 struct MonsterDesc;
 class Monster : public Character
 {
@@ -23,22 +31,31 @@ public:
         PICKUP = 32,
         DESTROY = 64,
         UNIQUE = 128,
-        BOSS = 256
+        BOSS = 256,
+        GLOW = 512 // lights the cells around it
     };
 
     Monster(mapsize_t x, mapsize_t y,
             char symbol,
-            std::vector<short> color,
+            ColorList color,
             int speed,
             int max_health,
             Abilities abilities,
             const MonsterDesc *desc,
             const Dice &dmg)
-        : Character(x, y, symbol, color, speed, max_health, dmg, MONSTER_ZINDEX),
+        : Character(EntityKind::MONSTER, x, y, symbol, color, speed, max_health, dmg, MONSTER_ZINDEX),
           desc(desc),
           abilities(abilities) {}
 
+    static constexpr bool is_kind(EntityKind k) { return k == EntityKind::MONSTER; }
+
     void get_desired_move(int &dx, int &dy, bool &force, GameContext &g) const;
+
+    // get_desired_move() from `flows` and the monster alone, so a batch of monsters can plan at
+    // once; false when the move needs a path search, and erratic monsters roll the dice first
+    bool plan_move(int &dx, int &dy, const MoveFlows &flows) const;
+    bool wants_item_flow() const { return (has(Abilities::PICKUP) || has(Abilities::DESTROY)) && !chasing(); }
+    bool wants_chase_flow() const { return has(Abilities::INTELLIGENT) && has(Abilities::TELEPATHIC) && !chasing(); }
     virtual bool move(int dx, int dy, GameContext &g, bool force = false) override;
 
     bool has(Abilities ability) const
@@ -51,7 +68,11 @@ public:
 
     void on_collision(Entity &other) override;
 
-    void update_sight(mapsize_t x, mapsize_t y, GameContext &g);
+    // Looks for the player from the current cell, remembering where they were seen
+    void update_sight(const GameContext &g);
+
+    // Nothing left to do until the player comes into sight, or a noise or a hit wakes it
+    bool idle() const;
 
     std::string abilities_string() const
     {
@@ -70,6 +91,8 @@ public:
             result += "PICKUP, ";
         if (has(Abilities::DESTROY))
             result += "DESTROY, ";
+        if (has(Abilities::GLOW))
+            result += "GLOW, ";
 
         if (result.length() < 2)
             return "<none>";
@@ -82,6 +105,8 @@ public:
     Abilities abilities;
 
 private:
+    bool chasing() const { return has_line_of_sight && target_x != EMPTY_TARGET && target_y != EMPTY_TARGET; }
+
     bool has_line_of_sight = false;
     mapsize_t target_x = EMPTY_TARGET;
     mapsize_t target_y = EMPTY_TARGET;
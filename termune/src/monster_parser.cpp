@@ -97,9 +97,9 @@ bool MonsterParser::validate(const MonsterDesc &m)
            m.rarity >= 1 && m.rarity <= 100;
 }
 
-std::unique_ptr<Monster> MonsterDesc::make_instance(mapsize_t x, mapsize_t y, std::mt19937 &rng) const
+Monster MonsterDesc::make_instance(mapsize_t x, mapsize_t y, std::mt19937 &rng) const
 {
-    auto m = std::make_unique<Monster>(
+    return Monster(
         x, y,
         symbol,
         colors,
@@ -108,6 +108,4 @@ std::unique_ptr<Monster> MonsterDesc::make_instance(mapsize_t x, mapsize_t y, st
         abilities,
         this,
         dam);
-
-    return m;
 }
\ No newline at end of file
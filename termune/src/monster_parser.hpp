@@ -27,7 +27,7 @@ struct MonsterDesc
     }
 
 public:
-    std::unique_ptr<Monster> make_instance(mapsize_t x, mapsize_t y, std::mt19937 &rng) const;
+    Monster make_instance(mapsize_t x, mapsize_t y, std::mt19937 &rng) const;
 };
 
 class MonsterParser : public Parser<MonsterDesc>
@@ -71,5 +71,7 @@ inline Monster::Abilities ability_from_string(const std::string &str)
         return Monster::Abilities::UNIQUE;
     if (str == "BOSS")
         return Monster::Abilities::BOSS;
+    if (str == "GLOW")
+        return Monster::Abilities::GLOW;
     return Monster::Abilities::NONE;
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 
 #include "object_item.hpp"
 #include "player.hpp"
+#include "monster.hpp"
 #include "entity.hpp"
 #include "ui.hpp"
 
@@ -11,7 +12,7 @@ constexpr mapsize_t OBJECT_ZINDEX = 1; // Below player and monsters
 
 ObjectEntity::ObjectEntity(mapsize_t x, mapsize_t y,
                            Type type,
-                           std::vector<short> color,
+                           ColorList color,
                            bool is_artifact,
                            const ObjectDesc *desc,
                            int weight,
@@ -23,7 +24,7 @@ ObjectEntity::ObjectEntity(mapsize_t x, mapsize_t y,
                            int attribute,
                            int value)
     : Object(type, is_artifact, desc, weight, hit, damage, dodge, defense, speed, attribute, value),
-      Entity(x, y, object_type_to_char(type), color, OBJECT_ZINDEX) {}
+      Entity(EntityKind::OBJECT, x, y, object_type_to_char(type), color, OBJECT_ZINDEX) {}
 
 Object ObjectEntity::create_object() const
 {
@@ -47,4 +48,10 @@ void ObjectEntity::on_collision(Entity &other)
       player->ui->display_message("Inventory full!");
     }
   }
+  else if (Monster *monster = other.as<Monster>())
+  {
+    // Carried off or destroyed, gone from the floor either way
+    if (monster->has(Monster::Abilities::PICKUP) || monster->has(Monster::Abilities::DESTROY))
+      active = false;
+  }
 }
@@ -12,7 +12,7 @@ class ObjectEntity : public Object, public Entity
 public:
     ObjectEntity(mapsize_t x, mapsize_t y,
                  Object::Type type,
-                 std::vector<short> color,
+                 ColorList color,
                  bool is_artifact,
                  const ObjectDesc *desc,
                  int weight,
@@ -24,6 +24,8 @@ public:
                  int attribute,
                  int value);
 
+    static constexpr bool is_kind(EntityKind k) { return k == EntityKind::OBJECT; }
+
     Object create_object() const;
 
     void on_collision(Entity &other) override;
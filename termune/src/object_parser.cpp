@@ -137,13 +137,11 @@ bool ObjectParser::validate(const ObjectDesc &o)
            o.rarity >= 1 && o.rarity <= 100;
 }
 
-std::unique_ptr<ObjectEntity> ObjectDesc::make_instance(mapsize_t x, mapsize_t y, std::mt19937 &rng) const
+ObjectEntity ObjectDesc::make_instance(mapsize_t x, mapsize_t y, std::mt19937 &rng) const
 {
-    auto obj = std::make_unique<ObjectEntity>(
+    return ObjectEntity(
         x, y, type, colors,
         is_artifact, this,
         weight.roll(rng), hit.roll(rng), dam, dodge.roll(rng),
         def.roll(rng), speed.roll(rng), attr.roll(rng), val.roll(rng));
-
-    return obj;
 }
@@ -23,7 +23,7 @@ struct ObjectDesc
     int rarity = -1;
 
 public:
-    std::unique_ptr<ObjectEntity> make_instance(mapsize_t x, mapsize_t y, std::mt19937 &rng) const;
+    ObjectEntity make_instance(mapsize_t x, mapsize_t y, std::mt19937 &rng) const;
 };
 
 class ObjectParser : public Parser<ObjectDesc>
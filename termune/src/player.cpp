@@ -6,15 +6,19 @@
 #include "ui.hpp"
 
 constexpr mapsize_t PLAYER_ZINDEX = 3; // Above monsters and items
+static const short PLAYER_COLORS[] = {COLOR_WHITE};
 
 Player::Player(mapsize_t x, mapsize_t y, ui::Context *ui)
-    : Character(x, y, '@', {COLOR_WHITE}, 10, 100, Dice{1, 1, 1}, PLAYER_ZINDEX), ui(ui) {}
+    : Character(EntityKind::PLAYER, x, y, '@', PLAYER_COLORS, 10, 100, Dice{1, 1, 1}, PLAYER_ZINDEX), ui(ui) {}
 
 bool Player::move(int, int, GameContext &g, bool)
 {
     int dx, dy;
     bool force;
 
+    if (!ui) // nobody to ask, e.g. the bench: the player stands still
+        return true;
+
     while (g.running && ui->running)
     {
         ui->wait_for_input(dx, dy, force);
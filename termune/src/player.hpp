@@ -15,6 +15,8 @@ class Player : public Character
 public:
     Player(mapsize_t x, mapsize_t y, ui::Context *ui = nullptr);
 
+    static constexpr bool is_kind(EntityKind k) { return k == EntityKind::PLAYER; }
+
     bool move(int, int, GameContext &g, bool) override;
 
     std::string_view name() const override;
@@ -47,4 +49,5 @@ public:
     // 10: Ring 1
     // 11: Ring 2
     std::array<Object, 12> equipment;
+    static constexpr int LIGHT_SLOT = 9;
 };
\ No newline at end of file
@@ -83,11 +83,8 @@ int main(int argc, char const *argv[])
 
     // Schedule all character events
     game.schedule_character_event(&game.player);
-    for (auto *m : game.filtered<Character>())
-    {
-        if (m != &game.player)
-            game.schedule_character_event(m);
-    }
+    for (auto *m : game.filter<Character>())
+        game.schedule_character_event(m);
 
     // Show title and run
     ui.display_title();
@@ -54,6 +54,9 @@ namespace ui
         fps_timeout.tv_sec = usec / 1000000;
         fps_timeout.tv_usec = usec % 1000000;
 
+        // A quarter of a frame for a path recompute on demand, half of every idle frame to finish it
+        game.set_path_budget(std::chrono::microseconds(usec / 4));
+
         for (size_t i = 0; i < static_cast<size_t>(Context::WindowID::COUNT); ++i)
         {
             windows[i] = newwin(WINDOW_SIZE[i][0], WINDOW_SIZE[i][1], WINDOW_SIZE[i][2], WINDOW_SIZE[i][3]);
@@ -80,6 +83,7 @@ namespace ui
         while (running && game.running)
         {
             update_game_window();
+            game.advance_paths(std::chrono::microseconds((fps_timeout.tv_sec * 1000000 + fps_timeout.tv_usec) / 2));
 
             fd_set fds;
             FD_ZERO(&fds);
@@ -96,10 +100,13 @@ namespace ui
             }
             else if (result == 0)
             {
+                if (exploring && mode == UIMode::DUNGEON && explore_step(dx, dy))
+                    return true;
                 continue;
             }
             else if (FD_ISSET(STDIN_FILENO, &fds))
             {
+                exploring = false; // any key takes back control
                 if (get_player_input(dx, dy, force))
                     return true;
             }
@@ -131,7 +138,7 @@ namespace ui
             break;
 
         case UIMode::LORE_MENU:
-            if (viewed_monster)
+            if (game.entities.get(viewed_monster))
                 display_monster_lore_menu();
             else if (viewed_item)
                 display_item_lore_menu();
@@ -328,9 +335,7 @@ namespace ui
 
         display_status("HP: %d  Monsters left: %ld, Tick: %ld",
                        game.player.health,
-                       game.filter<Monster>([](const Monster &m)
-                                            { return m.active; })
-                           .size(),
+                       game.entities.monsters().alive(),
                        game.current_tick());
     }
 
@@ -346,13 +351,16 @@ namespace ui
         std::vector<std::string> lines;
 
         int global_max_scroll = 0;
-        for (const auto &m : game.filtered<Monster>([](const Monster &m)
-                                                    { return m.active; }))
+        const auto &monsters = game.entities.monsters();
+        for (std::size_t i = 0; i < monsters.size(); ++i)
         {
-            int rel_x = m->x - game.player.x;
-            int rel_y = m->y - game.player.y;
+            if (!monsters.active[i])
+                continue;
 
-            std::string line = std::string(m->name()) + " at " +
+            int rel_x = monsters.x[i] - game.player.x;
+            int rel_y = monsters.y[i] - game.player.y;
+
+            std::string line = std::string(monsters.object[i]->name()) + " at " +
                                ((rel_y == 0)
                                     ? ""
                                     : (std::to_string(std::abs(rel_y)) + (rel_y < 0 ? " north" : " south"))) +
@@ -455,18 +463,20 @@ namespace ui
         mvwprintw(w, 0, 2, " Monster Description ");
         mvwprintw(w, LORE_WIN_HEIGHT - 1, 2, " Press [ESC] to return ");
 
+        const Monster *monster = game.entities.get(viewed_monster)->as<Monster>();
+
         // Name + BOSS
-        std::string name = std::string(viewed_monster->name());
-        std::string tag = viewed_monster->desc->has_ability(Monster::Abilities::BOSS) ? "  **(BOSS)**" : "";
+        std::string name = std::string(monster->name());
+        std::string tag = monster->desc->has_ability(Monster::Abilities::BOSS) ? "  **(BOSS)**" : "";
         std::string name_line = name + tag;
         int name_col = std::max(1, (LORE_WIN_WIDTH - static_cast<int>(name_line.length())) / 2);
         mvwprintw(w, 1, name_col, "%s", name_line.c_str());
 
         // Stats
-        int hp = viewed_monster->health;
-        int speed = viewed_monster->speed;
-        std::string dmg = viewed_monster->damage.to_string();
-        std::string abilities = viewed_monster->abilities_string();
+        int hp = monster->health;
+        int speed = monster->speed;
+        std::string dmg = monster->damage.to_string();
+        std::string abilities = monster->abilities_string();
 
         mvwprintw(w, 2, 2, "HEALTH: %d", hp);
         mvwprintw(w, 2, 26, "ABILITIES: %s", abilities.c_str());
@@ -474,7 +484,7 @@ namespace ui
         mvwprintw(w, 3, 26, "DAMAGE: %s", dmg.c_str());
 
         // Description
-        const std::string desc_str = std::string(viewed_monster->description());
+        const std::string desc_str = std::string(monster->description());
         std::vector<std::string> desc_lines;
         std::istringstream iss(desc_str);
         std::string line;
@@ -561,6 +571,10 @@ namespace ui
         // Movement
         case Command::REST:
             return true;
+        case Command::AUTO_EXPLORE:
+            exploring = true;
+            display_message("Exploring, press any key to stop.");
+            return false;
         case Command::MOVE_N:
             dy = -1;
             return true;
@@ -674,12 +688,32 @@ namespace ui
         }
     }
 
+    bool Context::explore_step(int &dx, int &dy)
+    {
+        exploring = false;
+
+        const auto &monsters = game.entities.monsters();
+        for (std::size_t i = 0; i < monsters.size(); ++i)
+            if (monsters.active[i] && game.visibility_at(monsters.x[i], monsters.y[i]).visible)
+            {
+                display_message("You see %s.", std::string(monsters.object[i]->name()).c_str());
+                return false;
+            }
+
+        if (!game.explore_flow().step(game.player.x, game.player.y, dx, dy))
+        {
+            display_message("Nothing left to explore.");
+            return false;
+        }
+
+        exploring = true;
+        return true;
+    }
+
     bool Context::handle_monster_list_input(Command cmd, int &dx, int &dy, bool &force)
     {
         int visible_rows = MONSTER_WIN_HEIGHT - 2;
-        size_t alive_monsters = game.filter<Monster>([](const Monster &m)
-                                                     { return m.active; })
-                                    .size();
+        size_t alive_monsters = game.entities.monsters().alive();
         int scroll_max = std::max(0UL, alive_monsters - visible_rows);
 
         switch (cmd)
@@ -744,12 +778,13 @@ namespace ui
             {
             case Command::INSPECT_ITEM:
                 viewed_item = obj;
+                viewed_monster = {};
                 mode = UIMode::LORE_MENU;
                 return false;
 
             case Command::DROP_ITEM:
+                game.add_entity(obj->to_entity(game.player.x, game.player.y)); // before the slot is emptied
                 game.player.inventory[index] = Object();
-                game.add_entity(std::make_unique<ObjectEntity>(obj->to_entity(game.player.x, game.player.y)));
                 break;
 
             case Command::EXPUNGE_ITEM:
@@ -927,7 +962,7 @@ namespace ui
                     Monster *m = e->as<Monster>();
                     if (m && m->active)
                     {
-                        viewed_monster = m;
+                        viewed_monster = m->handle();
                         vert_scroll = 0;
                         mode = UIMode::LORE_MENU;
                         return false;
@@ -138,12 +138,16 @@ namespace ui
         bool handle_lore_input(Command cmd, int &dx, int &dy, bool &force);          // monster + item
         bool handle_cursor_select_input(Command cmd, int &dx, int &dy, bool &force); // teleport + search
 
+        // next auto-explore move, false (and exploring stops) when there is none or a monster is in view
+        bool explore_step(int &dx, int &dy);
+
         // UI State
         UIMode mode = UIMode::DUNGEON;
         mapsize_t cursor_x = 0;
         mapsize_t cursor_y = 0;
         bool fog_of_war = true;
         bool show_hardness = false;
+        bool exploring = false; // auto-explore, one move per frame until a key is pressed
 
         int vert_scroll = 0;
         size_t list_open_frame = 0;
@@ -151,7 +155,7 @@ namespace ui
         Command selecting_slot_cmd = Command::NONE;
 
         Object *viewed_item = nullptr;
-        Monster *viewed_monster = nullptr;
+        EntityHandle viewed_monster; // a handle, the monster may be gone by the next frame
 
         std::size_t frame = 0;
         timeval fps_timeout = {0, 0};
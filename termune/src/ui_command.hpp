@@ -18,6 +18,7 @@ namespace ui
         MOVE_SW,
         MOVE_W,
         REST,
+        AUTO_EXPLORE,
         STAIRS_UP,
         STAIRS_DOWN,
 
@@ -83,6 +84,8 @@ namespace ui
         case '4':
         case 'h':
             return Command::MOVE_W;
+        case 'o':
+            return Command::AUTO_EXPLORE;
         case '>':
             return Command::STAIRS_DOWN;
         case '<':
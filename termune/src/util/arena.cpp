@@ -0,0 +1,39 @@
+#include "arena.hpp"
+
+void *Arena::allocate(std::size_t bytes, std::size_t align)
+{
+    if (!blocks_.empty())
+    {
+        Block &block = blocks_.back();
+        void *at = block.data.get() + used_;
+        std::size_t space = block.size - used_;
+        if (std::align(align, bytes, at, space))
+        {
+            used_ = block.size - space + bytes;
+            return at;
+        }
+    }
+
+    // Each new block at least doubles the capacity, so a round takes few of them
+    add_block(std::max({block_size_, capacity_, bytes + align}));
+    return allocate(bytes, align);
+}
+
+void Arena::reset()
+{
+    if (blocks_.size() > 1)
+    {
+        const std::size_t total = capacity_;
+        blocks_.clear();
+        capacity_ = 0;
+        add_block(total);
+    }
+    used_ = 0;
+}
+
+void Arena::add_block(std::size_t size)
+{
+    blocks_.push_back({std::unique_ptr<std::byte[]>(new std::byte[size]), size});
+    capacity_ += size;
+    used_ = 0;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <new>
+#include <utility>
+#include <type_traits>
+
+/**
+ * Memory for things that all go away together, like everything on one dungeon floor.
+ * Allocating bumps an offset through large blocks, nothing is freed on its own, and reset()
+ * takes it all back at once. A reset merges the blocks into one big enough for everything
+ * allocated since the last one, so later rounds of the same size never reach the system
+ * allocator.
+ */
+class Arena
+{
+public:
+    explicit Arena(std::size_t block_size = 64 * 1024) : block_size_(block_size) {}
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    void *allocate(std::size_t bytes, std::size_t align);
+
+    /** A copy of `n` values, good until the next reset. */
+    template <typename T>
+    T *copy(const T *values, std::size_t n)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Arena::copy() only copies plain values");
+        if (n == 0)
+            return nullptr;
+        T *out = static_cast<T *>(allocate(n * sizeof(T), alignof(T)));
+        std::memcpy(out, values, n * sizeof(T));
+        return out;
+    }
+
+    /** Forgets everything allocated. Runs no destructors, the owners of the objects do that. */
+    void reset();
+
+    std::size_t capacity() const { return capacity_; }
+    std::size_t block_count() const { return blocks_.size(); }
+
+private:
+    struct Block
+    {
+        std::unique_ptr<std::byte[]> data;
+        std::size_t size;
+    };
+
+    void add_block(std::size_t size);
+
+    std::vector<Block> blocks_;
+    std::size_t used_ = 0; // of the last block
+    std::size_t capacity_ = 0;
+    std::size_t block_size_;
+};
+
+/**
+ * Objects of one type carved out of an Arena. A destroyed object's slot goes on a free list
+ * for the next one, so a floor where things keep dying and spawning does not keep growing.
+ */
+template <typename T>
+class Pool
+{
+public:
+    explicit Pool(Arena &arena) : arena_(arena) {}
+    Pool(const Pool &) = delete;
+    Pool &operator=(const Pool &) = delete;
+
+    template <typename... Args>
+    T *create(Args &&...args)
+    {
+        void *slot;
+        if (free_)
+        {
+            slot = free_;
+            free_ = free_->next;
+        }
+        else
+        {
+            slot = arena_.allocate(SLOT_SIZE, SLOT_ALIGN);
+        }
+        return new (slot) T(std::forward<Args>(args)...);
+    }
+
+    void destroy(T *object)
+    {
+        object->~T();
+        free_ = new (static_cast<void *>(object)) FreeSlot{free_};
+    }
+
+    /** Forgets the free list, for when the arena is reset. Live objects must be destroyed first. */
+    void reset() { free_ = nullptr; }
+
+private:
+    struct FreeSlot
+    {
+        FreeSlot *next;
+    };
+
+    static constexpr std::size_t SLOT_SIZE = std::max(sizeof(T), sizeof(FreeSlot));
+    static constexpr std::size_t SLOT_ALIGN = std::max(alignof(T), alignof(FreeSlot));
+
+    Arena &arena_;
+    FreeSlot *free_ = nullptr;
+};
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+/**
+ * A grid of booleans, one bit per cell. Each row is padded to whole 64-bit words so row and
+ * grid operations run a word at a time; the padding bits are kept zero, so counting and
+ * comparing never have to mask them.
+ */
+class BitGrid
+{
+public:
+    using word_t = uint64_t;
+    static constexpr std::size_t WORD_BITS = 64;
+
+    BitGrid(std::size_t width, std::size_t height, bool value = false)
+        : width_(width), height_(height), words_((width + WORD_BITS - 1) / WORD_BITS),
+          data_(words_ * height)
+    {
+        fill(value);
+    }
+
+    bool in_bounds(std::size_t x, std::size_t y) const { return (x < width_) && (y < height_); }
+
+    bool at(std::size_t x, std::size_t y) const
+    {
+#ifdef GRID_EXTRA_CHECKING
+        if (!in_bounds(x, y))
+            throw std::out_of_range("BitGrid::at() - index out of bounds");
+#endif
+        return (data_[y * words_ + x / WORD_BITS] >> (x % WORD_BITS)) & 1;
+    }
+
+    bool operator()(std::size_t x, std::size_t y) const { return at(x, y); }
+
+    /** Cells [x, x + n) of row y as bits 0..n-1, n < 64. Cells past the row's end read 0. */
+    word_t bits(std::size_t x, std::size_t y, std::size_t n) const
+    {
+        const word_t *r = row(y);
+        const std::size_t i = x / WORD_BITS, shift = x % WORD_BITS;
+        word_t v = r[i] >> shift;
+        if (shift && i + 1 < words_)
+            v |= r[i + 1] << (WORD_BITS - shift);
+        return v & ((word_t(1) << n) - 1);
+    }
+
+    /** Sets cell (x + i, y) for every bit i of `bits`, all of which must lie on the row. */
+    void set_bits(std::size_t x, std::size_t y, word_t bits)
+    {
+        word_t *r = row(y);
+        const std::size_t i = x / WORD_BITS, shift = x % WORD_BITS;
+        r[i] |= bits << shift;
+        if (shift && i + 1 < words_)
+            r[i + 1] |= bits >> (WORD_BITS - shift);
+    }
+
+    void set(std::size_t x, std::size_t y, bool value = true)
+    {
+#ifdef GRID_EXTRA_CHECKING
+        if (!in_bounds(x, y))
+            throw std::out_of_range("BitGrid::set() - index out of bounds");
+#endif
+        word_t &word = data_[y * words_ + x / WORD_BITS];
+        const word_t bit = word_t(1) << (x % WORD_BITS);
+        word = value ? (word | bit) : (word & ~bit);
+    }
+
+    void fill(bool value)
+    {
+        std::fill(data_.begin(), data_.end(), value ? ~word_t(0) : 0);
+        if (value)
+            clear_padding();
+    }
+
+    /** Sets cells [x0, x1) of row y, whole words at a time. */
+    void fill_span(std::size_t y, std::size_t x0, std::size_t x1, bool value)
+    {
+        if (x0 >= x1)
+            return;
+
+        word_t *r = row(y);
+        const std::size_t first = x0 / WORD_BITS, last = (x1 - 1) / WORD_BITS;
+        for (std::size_t i = first; i <= last; ++i)
+        {
+            word_t mask = ~word_t(0);
+            if (i == first)
+                mask &= ~word_t(0) << (x0 % WORD_BITS);
+            if (i == last && x1 % WORD_BITS)
+                mask &= ~word_t(0) >> (WORD_BITS - x1 % WORD_BITS);
+            r[i] = value ? (r[i] | mask) : (r[i] & ~mask);
+        }
+    }
+
+    /** Cells that are set, in the whole grid or in one row. */
+    std::size_t count() const
+    {
+        std::size_t n = 0;
+        for (word_t w : data_)
+            n += __builtin_popcountll(w);
+        return n;
+    }
+
+    std::size_t count_row(std::size_t y) const
+    {
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < words_; ++i)
+            n += __builtin_popcountll(row(y)[i]);
+        return n;
+    }
+
+    bool any() const
+    {
+        return std::any_of(data_.begin(), data_.end(), [](word_t w)
+                           { return w != 0; });
+    }
+
+    // Cell-wise operations with a grid of the same size
+    BitGrid &operator&=(const BitGrid &other) { return combine(other, std::bit_and<word_t>()); }
+    BitGrid &operator|=(const BitGrid &other) { return combine(other, std::bit_or<word_t>()); }
+    BitGrid &operator^=(const BitGrid &other) { return combine(other, std::bit_xor<word_t>()); }
+
+    /** Clears every cell set in `other`. */
+    BitGrid &andnot(const BitGrid &other)
+    {
+        return combine(other, [](word_t a, word_t b)
+                       { return a & ~b; });
+    }
+
+    bool operator==(const BitGrid &other) const
+    {
+        return width_ == other.width_ && height_ == other.height_ && data_ == other.data_;
+    }
+    bool operator!=(const BitGrid &other) const { return !(*this == other); }
+
+    /**
+     * `out` = every cell set here plus its 8 neighbors. `out` must be the same size and not
+     * this grid.
+     */
+    void dilate(BitGrid &out) const
+    {
+        std::vector<word_t> spread(3 * words_);
+        word_t *rows[3] = {&spread[0], &spread[words_], &spread[2 * words_]};
+
+        // rows[(y + 1) % 3] is the horizontally dilated row y
+        std::fill_n(rows[0], words_, 0);
+        if (height_ > 0)
+            dilate_row(row(0), rows[1], words_);
+
+        for (std::size_t y = 0; y < height_; ++y)
+        {
+            word_t *above = rows[y % 3], *same = rows[(y + 1) % 3], *below = rows[(y + 2) % 3];
+            if (y + 1 < height_)
+                dilate_row(row(y + 1), below, words_);
+            else
+                std::fill_n(below, words_, 0);
+
+            word_t *o = out.row(y);
+            for (std::size_t i = 0; i < words_; ++i)
+                o[i] = above[i] | same[i] | below[i];
+            if (words_ > 0)
+                o[words_ - 1] &= tail_mask();
+        }
+    }
+
+    /**
+     * One row of `words` words spread one cell left and right, carrying bits across words.
+     * The spread can reach into the padding, callers mask it off.
+     */
+    static void dilate_row(const word_t *in, word_t *out, std::size_t words)
+    {
+        for (std::size_t i = 0; i < words; ++i)
+        {
+            word_t left = i > 0 ? in[i - 1] >> (WORD_BITS - 1) : 0;
+            word_t right = i + 1 < words ? in[i + 1] << (WORD_BITS - 1) : 0;
+            out[i] = in[i] | (in[i] << 1) | (in[i] >> 1) | left | right;
+        }
+    }
+
+    word_t *row(std::size_t y) { return &data_[y * words_]; }
+    const word_t *row(std::size_t y) const { return &data_[y * words_]; }
+
+    word_t *data() { return data_.data(); }
+    const word_t *data() const { return data_.data(); }
+
+    std::size_t width() const { return width_; }
+    std::size_t height() const { return height_; }
+    std::size_t words_per_row() const { return words_; }
+
+    /** Bits of the last word of a row that are real cells. */
+    word_t tail_mask() const
+    {
+        return width_ % WORD_BITS ? ~word_t(0) >> (WORD_BITS - width_ % WORD_BITS) : ~word_t(0);
+    }
+
+private:
+    template <typename Op>
+    BitGrid &combine(const BitGrid &other, Op op)
+    {
+        if (other.width_ != width_ || other.height_ != height_)
+            throw std::invalid_argument("BitGrid - grid sizes do not match");
+        for (std::size_t i = 0; i < data_.size(); ++i)
+            data_[i] = op(data_[i], other.data_[i]);
+        return *this;
+    }
+
+    void clear_padding()
+    {
+        if (words_ == 0)
+            return;
+        for (std::size_t y = 0; y < height_; ++y)
+            row(y)[words_ - 1] &= tail_mask();
+    }
+
+    std::size_t width_, height_;
+    std::size_t words_; // per row
+    std::vector<word_t> data_;
+};
@@ -2,6 +2,31 @@
 
 #include <ncurses.h>
 #include <string>
+#include <vector>
+#include <cstddef>
+
+// Colors owned elsewhere (a description, static storage), read like a vector
+class ColorList
+{
+public:
+    ColorList() = default;
+    ColorList(const short *data, std::size_t size) : data_(data), size_(size) {}
+    ColorList(const std::vector<short> &colors) : data_(colors.data()), size_(colors.size()) {}
+    ColorList(const std::vector<short> &&) = delete; // would dangle
+    template <std::size_t N>
+    ColorList(const short (&colors)[N]) : data_(colors), size_(N) {}
+
+    const short *data() const { return data_; }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    short operator[](std::size_t i) const { return data_[i]; }
+    const short *begin() const { return data_; }
+    const short *end() const { return data_ + size_; }
+
+private:
+    const short *data_ = nullptr;
+    std::size_t size_ = 0;
+};
 
 inline short color_from_string(const std::string &str)
 {
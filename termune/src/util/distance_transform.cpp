@@ -0,0 +1,121 @@
+#include "util/distance_transform.hpp"
+
+#include <algorithm>
+
+namespace DistanceTransform
+{
+    template <typename T>
+    void bit_bfs_begin(Workspace &ws, const BitGrid &blocked, std::size_t source,
+                       Grid<T> &dist)
+    {
+        const std::size_t w = blocked.width();
+        const std::size_t h = blocked.height();
+        const std::size_t words = blocked.words_per_row();
+
+        ws.open.resize(words * h);
+        ws.visited.assign(words * h, 0);
+        ws.frontier.resize(words * h); // only read on rows inside the frontier's row range
+        ws.next.resize(words * h);
+        ws.spread.resize(words * h);
+
+        // Same row layout as the BitGrid, so open cells are its words inverted
+        for (std::size_t y = 0; y < h; ++y)
+            for (std::size_t i = 0; i < words; ++i)
+                ws.open[y * words + i] = ~blocked.row(y)[i] & (i + 1 == words ? blocked.tail_mask() : ~uint64_t(0));
+
+        dist.fill(std::numeric_limits<T>::max());
+        ws.levels = 0;
+        ws.done = blocked.at(source % w, source / w);
+        if (ws.done)
+            return;
+
+        const std::size_t sx = source % w, sy = source / w;
+        std::fill_n(&ws.frontier[sy * words], words, 0);
+        ws.frontier[sy * words + sx / 64] = uint64_t(1) << (sx % 64);
+        ws.visited[sy * words + sx / 64] = ws.frontier[sy * words + sx / 64];
+        dist.data()[source] = 0;
+
+        // Only rows [lo, hi] of the frontier can be non-zero
+        ws.lo = ws.hi = sy;
+    }
+
+    template <typename T>
+    bool bit_bfs_resume(Workspace &ws, Grid<T> &dist, std::size_t budget)
+    {
+        const std::size_t h = dist.height();
+        const std::size_t words = (dist.width() + 63) / 64;
+        std::size_t lo = ws.lo, hi = ws.hi;
+
+        for (std::size_t done = 0; !ws.done; ++done)
+        {
+            if (done == budget)
+            {
+                ws.lo = lo;
+                ws.hi = hi;
+                return false;
+            }
+
+            const T level = static_cast<T>(++ws.levels);
+
+            // Horizontal dilation of each frontier row, spill into the padding is masked below
+            for (std::size_t y = lo; y <= hi; ++y)
+                BitGrid::dilate_row(&ws.frontier[y * words], &ws.spread[y * words], words);
+
+            // Vertical dilation, masked to open cells not reached yet
+            const std::size_t next_lo = lo > 0 ? lo - 1 : 0;
+            const std::size_t next_hi = hi + 1 < h ? hi + 1 : hi;
+            std::size_t new_lo = h, new_hi = 0;
+
+            for (std::size_t y = next_lo; y <= next_hi; ++y)
+            {
+                const uint64_t *above = y > lo && y - 1 <= hi ? &ws.spread[(y - 1) * words] : nullptr;
+                const uint64_t *same = y >= lo && y <= hi ? &ws.spread[y * words] : nullptr;
+                const uint64_t *below = y + 1 >= lo && y + 1 <= hi ? &ws.spread[(y + 1) * words] : nullptr;
+
+                uint64_t *n = &ws.next[y * words];
+                uint64_t any = 0;
+                for (std::size_t i = 0; i < words; ++i)
+                {
+                    uint64_t v = (above ? above[i] : 0) | (same ? same[i] : 0) | (below ? below[i] : 0);
+                    v &= ws.open[y * words + i] & ~ws.visited[y * words + i];
+                    n[i] = v;
+                    ws.visited[y * words + i] |= v;
+                    any |= v;
+
+                    for (uint64_t bits = v; bits; bits &= bits - 1)
+                        dist(i * 64 + __builtin_ctzll(bits), y) = level;
+                }
+
+                if (any)
+                {
+                    new_lo = std::min(new_lo, y);
+                    new_hi = std::max(new_hi, y);
+                }
+            }
+
+            if (new_lo > new_hi)
+            {
+                ws.done = true;
+                break;
+            }
+
+            std::swap(ws.frontier, ws.next);
+            lo = new_lo;
+            hi = new_hi;
+        }
+        return true;
+    }
+
+    template <typename T>
+    void bit_bfs(Workspace &ws, const BitGrid &blocked, std::size_t source,
+                 Grid<T> &dist)
+    {
+        bit_bfs_begin(ws, blocked, source, dist);
+        bit_bfs_resume(ws, dist, SIZE_MAX);
+    }
+
+    template void bit_bfs<uint16_t>(Workspace &, const BitGrid &, std::size_t, Grid<uint16_t> &);
+    template void bit_bfs<uint32_t>(Workspace &, const BitGrid &, std::size_t, Grid<uint32_t> &);
+    template void bit_bfs_begin<uint32_t>(Workspace &, const BitGrid &, std::size_t, Grid<uint32_t> &);
+    template bool bit_bfs_resume<uint32_t>(Workspace &, Grid<uint32_t> &, std::size_t);
+} // namespace DistanceTransform
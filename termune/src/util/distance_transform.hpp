@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+
+#include "util/grid.hpp"
+#include "util/bit_grid.hpp"
+
+/**
+ * Unweighted 8-connected distance maps (every step costs 1) from a single source, as an
+ * alternative to Dijkstra when all open cells cost the same. Cells that are blocked or not
+ * reachable are set to the maximum value of the output type.
+ */
+namespace DistanceTransform
+{
+    class Workspace
+    {
+    public:
+        // One bit per cell, rows padded to whole words
+        std::vector<uint64_t> open, visited, frontier, next, spread;
+
+        std::size_t levels = 0; /**< BFS levels of the last run */
+
+        // Where a resumable bit_bfs left off
+        std::size_t lo = 0, hi = 0; /**< Rows that can hold frontier bits */
+        bool done = true;
+    };
+
+    /**
+     * Bit-parallel BFS: the frontier is a bitset per row, and each level dilates it by one
+     * cell in every direction with word shifts, masked by open and not yet visited cells.
+     */
+    template <typename T>
+    void bit_bfs(Workspace &ws, const BitGrid &blocked, std::size_t source,
+                 Grid<T> &dist);
+
+    /**
+     * Resumable bit_bfs: begin, then each resume runs at most `budget` levels and returns
+     * true once the map is complete. `blocked` is only read by bit_bfs_begin; cells opened
+     * after that stay unreached and should be fixed up by the caller.
+     */
+    template <typename T>
+    void bit_bfs_begin(Workspace &ws, const BitGrid &blocked, std::size_t source,
+                       Grid<T> &dist);
+    template <typename T>
+    bool bit_bfs_resume(Workspace &ws, Grid<T> &dist, std::size_t budget);
+} // namespace DistanceTransform
@@ -1,69 +1,216 @@
 #pragma once
 
-#include <queue>
 #include <vector>
-#include <functional>
+#include <cstdint>
+#include <cstddef>
 #include <algorithm>
 
+#include "types.hpp"
+
+/**
+ * Events are plain records (tick, actor, kind) that the owner dispatches itself, kept in a
+ * binary min-heap ordered by tick, with ties in the order they were scheduled.
+ *
+ * Every scheduled event has a handle, good until the event is popped or cancelled, which
+ * cancels or moves it in O(log n). Records live in slots reused through a free list, so once
+ * the queue has grown scheduling allocates nothing.
+ */
+template <typename Actor>
 class EventQueue
 {
 public:
-    // Function signature for the callback, which returns true if the event should halt the queue
-    using Callback = std::function<bool()>;
+    using Handle = uint32_t;
+    static constexpr Handle NO_EVENT = UINT32_MAX;
+
+    struct Event
+    {
+        tick_t tick;
+        Actor *actor;
+        uint8_t kind;
+    };
+
+    Handle add(Actor *actor, uint8_t kind, tick_t delay);
+
+    /** Drops the event if it is still scheduled, and clears the handle. */
+    void cancel(Handle &handle);
+
+    /** Moves a scheduled event to `delay` ticks from now, behind events already due then. */
+    void reschedule(Handle handle, tick_t delay);
+
+    bool scheduled(Handle handle) const
+    {
+        return handle < slots_.size() && slots_[handle].pos != NOT_QUEUED;
+    }
+
+    bool empty() const { return heap_.empty(); }
+    std::size_t size() const { return heap_.size(); }
+
+    /** Removes the earliest event and advances the current tick to it. */
+    Event pop();
+
+    /** The earliest event if it is due at the current tick too, without removing it. */
+    const Event *due_now() const
+    {
+        return !heap_.empty() && heap_.front().tick == current_tick_ ? &slots_[heap_.front().handle].event : nullptr;
+    }
 
-    void add(Callback cb, tick_t delay);
-    void process();
-    bool process_one();
     void flush();
-    tick_t current_tick() const;
+    tick_t current_tick() const { return current_tick_; }
 
 private:
-    struct Event
+    static constexpr uint32_t NOT_QUEUED = UINT32_MAX;
+
+    struct Slot
     {
-        Callback callback;
-        tick_t target_tick;
-        bool operator>(const Event &other) const
-        {
-            return target_tick > other.target_tick;
-        }
+        Event event;
+        uint32_t pos; /**< Index in heap_, NOT_QUEUED when free */
     };
 
-    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> queue_;
+    // The ordering key lives in the heap itself, so sifting never touches the slots to compare
+    struct Node
+    {
+        tick_t tick;
+        uint64_t seq; /**< Scheduling order, breaks ties between equal ticks */
+        Handle handle;
+
+        bool operator<(const Node &o) const { return tick != o.tick ? tick < o.tick : seq < o.seq; }
+    };
+
+    void place(std::size_t pos, const Node &node)
+    {
+        heap_[pos] = node;
+        slots_[node.handle].pos = static_cast<uint32_t>(pos);
+    }
+
+    void sift_up(std::size_t pos);
+    void sift_down(std::size_t pos);
+    void remove_at(std::size_t pos);
+
+    std::vector<Slot> slots_;
+    std::vector<Handle> free_;
+    std::vector<Node> heap_;
+    uint64_t next_seq_ = 0;
     tick_t current_tick_ = 0;
 };
 
-inline void EventQueue::add(Callback cb, tick_t delay)
+template <typename Actor>
+typename EventQueue<Actor>::Handle EventQueue<Actor>::add(Actor *actor, uint8_t kind, tick_t delay)
 {
-    queue_.push({std::move(cb), current_tick_ + delay});
+    Handle handle;
+    if (!free_.empty())
+    {
+        handle = free_.back();
+        free_.pop_back();
+    }
+    else
+    {
+        handle = static_cast<Handle>(slots_.size());
+        slots_.emplace_back();
+    }
+
+    slots_[handle].event = {current_tick_ + delay, actor, kind};
+    heap_.push_back({current_tick_ + delay, next_seq_++, handle});
+    slots_[handle].pos = static_cast<uint32_t>(heap_.size() - 1);
+    sift_up(heap_.size() - 1);
+    return handle;
 }
 
-inline void EventQueue::process()
+template <typename Actor>
+void EventQueue<Actor>::cancel(Handle &handle)
 {
-    while (!queue_.empty() && !process_one())
-        ;
+    if (scheduled(handle))
+    {
+        remove_at(slots_[handle].pos);
+        free_.push_back(handle);
+    }
+    handle = NO_EVENT;
 }
 
-inline bool EventQueue::process_one()
+template <typename Actor>
+void EventQueue<Actor>::reschedule(Handle handle, tick_t delay)
 {
-    if (!queue_.empty())
-    {
-        auto event = queue_.top();
-        queue_.pop();
+    if (!scheduled(handle))
+        return;
+
+    Slot &slot = slots_[handle];
+    slot.event.tick = current_tick_ + delay;
+    heap_[slot.pos].tick = slot.event.tick;
+    heap_[slot.pos].seq = next_seq_++;
+    sift_up(slot.pos);
+    sift_down(slot.pos);
+}
 
-        current_tick_ = std::max(current_tick_, event.target_tick);
+template <typename Actor>
+typename EventQueue<Actor>::Event EventQueue<Actor>::pop()
+{
+    const Handle handle = heap_.front().handle;
+    Event event = slots_[handle].event;
+    remove_at(0);
+    free_.push_back(handle);
+
+    current_tick_ = std::max(current_tick_, event.tick);
+    return event;
+}
 
-        return event.callback();
+template <typename Actor>
+void EventQueue<Actor>::flush()
+{
+    for (const Node &node : heap_)
+    {
+        slots_[node.handle].pos = NOT_QUEUED;
+        free_.push_back(node.handle);
+    }
+    heap_.clear();
+}
+
+template <typename Actor>
+void EventQueue<Actor>::sift_up(std::size_t pos)
+{
+    const Node node = heap_[pos];
+    while (pos > 0)
+    {
+        std::size_t parent = (pos - 1) / 2;
+        if (!(node < heap_[parent]))
+            break;
+        place(pos, heap_[parent]);
+        pos = parent;
     }
-    return true;
+    place(pos, node);
 }
 
-inline void EventQueue::flush()
+template <typename Actor>
+void EventQueue<Actor>::sift_down(std::size_t pos)
 {
-    while (!queue_.empty())
-        queue_.pop();
+    const Node node = heap_[pos];
+    const std::size_t n = heap_.size();
+    while (true)
+    {
+        std::size_t child = 2 * pos + 1;
+        if (child >= n)
+            break;
+        if (child + 1 < n && heap_[child + 1] < heap_[child])
+            ++child;
+        if (!(heap_[child] < node))
+            break;
+        place(pos, heap_[child]);
+        pos = child;
+    }
+    place(pos, node);
 }
 
-inline tick_t EventQueue::current_tick() const
+template <typename Actor>
+void EventQueue<Actor>::remove_at(std::size_t pos)
 {
-    return current_tick_;
+    const Handle removed = heap_[pos].handle;
+    const Node last = heap_.back();
+    heap_.pop_back();
+    slots_[removed].pos = NOT_QUEUED;
+
+    // The last record fills the hole, then moves whichever way it is out of order
+    if (removed != last.handle)
+    {
+        place(pos, last);
+        sift_up(pos);
+        sift_down(slots_[last.handle].pos);
+    }
 }
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "util/grid.hpp"
+#include "util/pathing.hpp"
+
+namespace Pathing
+{
+    /**
+     * The best move out of every cell of a distance map, packed into 4 bits per cell (an
+     * index into Neighborhood<EIGHT>, or NONE). Following it from any cell walks a shortest
+     * path to the map's source, one lookup per move instead of scanning all neighbors.
+     *
+     * Cells are resolved on first lookup and cached, so resetting the field after the map
+     * changes only clears it; resolve_all() fills in every cell up front instead.
+     * The distance map must stay alive and unchanged until the next reset().
+     */
+    class FlowField
+    {
+    public:
+        static constexpr uint8_t NONE = 8;      /**< At the source, or no neighbor gets closer */
+        static constexpr uint8_t UNKNOWN = 0xF; /**< Not resolved since the last reset */
+
+        /** Follow `dist` from now on, forgetting every resolved cell. */
+        void reset(const Grid<cost_t> &dist)
+        {
+            dist_ = &dist;
+            width_ = dist.width();
+            height_ = dist.height();
+            packed_.assign((width_ * height_ + 1) / 2, 0xFF);
+        }
+
+        /** Resolve every cell now, for when most of the map is going to be looked up. */
+        void resolve_all()
+        {
+            const std::size_t w = width_, h = height_; // byte stores below may alias members
+            uint8_t *out = packed_.data();
+            for (std::size_t y = 0; y < h; ++y)
+                for (std::size_t x = 0; x < w; ++x)
+                {
+                    const std::size_t idx = y * w + x;
+                    const int shift = idx % 2 * 4;
+                    out[idx / 2] = static_cast<uint8_t>((out[idx / 2] & ~(0xF << shift)) |
+                                                        best_direction(x, y) << shift);
+                }
+        }
+
+        uint8_t direction(std::size_t x, std::size_t y)
+        {
+            const std::size_t idx = y * width_ + x;
+            uint8_t &byte = packed_[idx / 2];
+            const int shift = idx % 2 * 4;
+
+            uint8_t dir = (byte >> shift) & 0xF;
+            if (dir == UNKNOWN)
+            {
+                dir = best_direction(x, y);
+                byte = static_cast<uint8_t>((byte & ~(0xF << shift)) | dir << shift);
+            }
+            return dir;
+        }
+
+        /** The move out of (x, y), false if there is none. */
+        bool step(std::size_t x, std::size_t y, int &dx, int &dy)
+        {
+            uint8_t dir = direction(x, y);
+            if (dir == NONE)
+                return false;
+            dx = Neighborhood<Connectivity::EIGHT>::dx[dir];
+            dy = Neighborhood<Connectivity::EIGHT>::dy[dir];
+            return true;
+        }
+
+        /** step() that resolves without caching, so several threads can follow the field at once. */
+        bool step(std::size_t x, std::size_t y, int &dx, int &dy) const
+        {
+            const std::size_t idx = y * width_ + x;
+            uint8_t dir = (packed_[idx / 2] >> (idx % 2 * 4)) & 0xF;
+            if (dir == UNKNOWN)
+                dir = best_direction(x, y);
+            if (dir == NONE)
+                return false;
+            dx = Neighborhood<Connectivity::EIGHT>::dx[dir];
+            dy = Neighborhood<Connectivity::EIGHT>::dy[dir];
+            return true;
+        }
+
+        std::size_t bytes() const { return packed_.size(); }
+
+    private:
+        // Cheapest neighbor if it is cheaper than the cell itself, first one on ties
+        uint8_t best_direction(std::size_t x, std::size_t y) const
+        {
+            using N = Neighborhood<Connectivity::EIGHT>;
+
+            const cost_t *d = dist_->data();
+            cost_t best = d[y * width_ + x];
+            uint8_t best_dir = NONE;
+            for (int i = 0; i < N::count; ++i)
+            {
+                std::size_t nx = x + N::dx[i], ny = y + N::dy[i]; // wraps past 0, caught below
+                if (nx < width_ && ny < height_ && d[ny * width_ + nx] < best)
+                {
+                    best = d[ny * width_ + nx];
+                    best_dir = static_cast<uint8_t>(i);
+                }
+            }
+            return best_dir;
+        }
+
+        const Grid<cost_t> *dist_ = nullptr;
+        std::size_t width_ = 0, height_ = 0;
+        std::vector<uint8_t> packed_;
+    };
+} // namespace Pathing
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "util/grid.hpp"
+#include "util/pathing.hpp"
+#include "util/flow_field.hpp"
+
+namespace Pathing
+{
+    /**
+     * Distance to the nearest of any number of goal cells (items, unexplored edges, ...),
+     * with a flow field on top so following it costs one lookup per move.
+     *
+     * The map is solved once, on the first request after reset() or invalidate(), and
+     * after that kept exact in place: an added goal or a cheaper cell only expands the cells
+     * that get closer, a removed goal only re-derives the cells that were heading for it.
+     * Every call takes the same `step_cost(from, to)` functor as solve().
+     */
+    class GoalMap
+    {
+    public:
+        void reset(std::size_t width, std::size_t height)
+        {
+            if (dist_.width() == width && dist_.height() == height)
+                dist_.fill(UNREACHABLE); // the next floor is usually the same size
+            else
+                dist_ = Grid<cost_t>(width, height, UNREACHABLE);
+            goal_.assign(width * height, 0);
+            goals_ = 0;
+            valid_ = false;
+        }
+
+        /** Forget the distances (not the goals), e.g. after many cells changed at once. */
+        void invalidate() { valid_ = false; }
+
+        bool is_goal(std::size_t idx) const { return goal_[idx]; }
+        std::size_t goal_count() const { return goals_; }
+
+        template <typename StepCost>
+        void set_goal(std::size_t idx, bool goal, StepCost &&step_cost)
+        {
+            if (bool(goal_[idx]) == goal)
+                return;
+            goal_[idx] = goal;
+            goals_ += goal ? 1 : -1;
+
+            if (!valid_)
+                return;
+            if (goal)
+                expanded_ += repair_add_source(ws_, dist_, idx, step_cost);
+            else
+                expanded_ += repair_increase(ws_, dist_, idx, step_cost);
+            flow_current_ = false;
+        }
+
+        /** Stepping into `idx` got cheaper or became possible. */
+        template <typename StepCost>
+        void cost_decreased(std::size_t idx, StepCost &&step_cost)
+        {
+            if (!valid_)
+                return;
+            expanded_ += repair_decrease(ws_, dist_, idx, step_cost);
+            flow_current_ = false;
+        }
+
+        template <typename StepCost>
+        const Grid<cost_t> &get(StepCost &&step_cost)
+        {
+            if (!valid_)
+            {
+                sources_.clear();
+                for (std::size_t i = 0; i < goal_.size(); ++i)
+                    if (goal_[i])
+                        sources_.push_back(i);
+
+                solve_begin(ws_, dist_, sources_);
+                solve_resume(ws_, dist_, step_cost, SIZE_MAX);
+                expanded_ += ws_.expanded;
+                valid_ = true;
+                flow_current_ = false;
+            }
+            return dist_;
+        }
+
+        template <typename StepCost>
+        FlowField &flow(StepCost &&step_cost)
+        {
+            const Grid<cost_t> &dist = get(step_cost);
+            if (!flow_current_)
+            {
+                flow_.reset(dist);
+                flow_current_ = true;
+            }
+            return flow_;
+        }
+
+        /** Nodes expanded by every solve and repair so far. */
+        std::size_t expanded() const { return expanded_; }
+
+    private:
+        Grid<cost_t> dist_{0, 0};
+        std::vector<uint8_t> goal_;
+        std::size_t goals_ = 0;
+        bool valid_ = false;
+
+        FlowField flow_;
+        bool flow_current_ = false;
+
+        Workspace ws_; // repair_increase() walks its prev tree, so only this map may use it
+        std::vector<std::size_t> sources_;
+        std::size_t expanded_ = 0;
+    };
+} // namespace Pathing
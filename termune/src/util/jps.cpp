@@ -0,0 +1,202 @@
+#include "util/jps.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace Pathing
+{
+    static int sign(long v)
+    {
+        return (v > 0) - (v < 0);
+    }
+
+    cost_t JumpPointSearch::heuristic(std::size_t idx) const
+    {
+        // Chebyshev distance: exact on an empty grid when diagonals cost 1
+        long dx = std::labs(long(idx % width_) - long(goal_ % width_));
+        long dy = std::labs(long(idx / width_) - long(goal_ / width_));
+        return static_cast<cost_t>(std::max(dx, dy));
+    }
+
+    // Walk from (x, y) in direction (dx, dy) until a jump point, the goal, or a wall
+    std::size_t JumpPointSearch::jump(long x, long y, int dx, int dy) const
+    {
+        while (true)
+        {
+            x += dx;
+            y += dy;
+            if (!open(x, y))
+                return NO_NODE;
+
+            std::size_t idx = y * width_ + x;
+            if (idx == goal_)
+                return idx;
+
+            if (dx != 0 && dy != 0)
+            {
+                if ((!open(x - dx, y) && open(x - dx, y + dy)) ||
+                    (!open(x, y - dy) && open(x + dx, y - dy)))
+                    return idx;
+
+                // A diagonal step is a jump point if either straight component finds one
+                if (jump(x, y, dx, 0) != NO_NODE || jump(x, y, 0, dy) != NO_NODE)
+                    return idx;
+            }
+            else if (dx != 0)
+            {
+                if ((!open(x, y + 1) && open(x + dx, y + 1)) ||
+                    (!open(x, y - 1) && open(x + dx, y - 1)))
+                    return idx;
+            }
+            else
+            {
+                if ((!open(x + 1, y) && open(x + 1, y + dy)) ||
+                    (!open(x - 1, y) && open(x - 1, y + dy)))
+                    return idx;
+            }
+        }
+    }
+
+    void JumpPointSearch::visit(std::size_t idx, std::size_t from, cost_t g)
+    {
+        if (stamp_[idx] == query_ && g_[idx] <= g)
+            return;
+
+        stamp_[idx] = query_;
+        g_[idx] = g;
+        prev_[idx] = from;
+        open_set_.push(g + heuristic(idx), idx);
+    }
+
+    void JumpPointSearch::expand(std::size_t idx)
+    {
+        const long x = idx % width_;
+        const long y = idx / width_;
+
+        // Pruned directions: natural neighbors plus forced ones, relative to the parent
+        int dirs[8][2];
+        int n = 0;
+
+        if (prev_[idx] == NO_NODE)
+        {
+            for (int dy = -1; dy <= 1; ++dy)
+                for (int dx = -1; dx <= 1; ++dx)
+                    if (dx || dy)
+                    {
+                        dirs[n][0] = dx;
+                        dirs[n++][1] = dy;
+                    }
+        }
+        else
+        {
+            const int dx = sign(x - long(prev_[idx] % width_));
+            const int dy = sign(y - long(prev_[idx] / width_));
+
+            auto add = [&](int ddx, int ddy)
+            {
+                dirs[n][0] = ddx;
+                dirs[n++][1] = ddy;
+            };
+
+            if (dx != 0 && dy != 0)
+            {
+                add(dx, 0);
+                add(0, dy);
+                add(dx, dy);
+                if (!open(x - dx, y))
+                    add(-dx, dy);
+                if (!open(x, y - dy))
+                    add(dx, -dy);
+            }
+            else if (dx != 0)
+            {
+                add(dx, 0);
+                if (!open(x, y + 1))
+                    add(dx, 1);
+                if (!open(x, y - 1))
+                    add(dx, -1);
+            }
+            else
+            {
+                add(0, dy);
+                if (!open(x + 1, y))
+                    add(1, dy);
+                if (!open(x - 1, y))
+                    add(-1, dy);
+            }
+        }
+
+        for (int i = 0; i < n; ++i)
+        {
+            std::size_t next = jump(x, y, dirs[i][0], dirs[i][1]);
+            if (next == NO_NODE)
+                continue;
+
+            // Jumps follow a straight or diagonal line, so the step count is Chebyshev
+            long steps = std::max(std::labs(long(next % width_) - x), std::labs(long(next / width_) - y));
+            visit(next, idx, g_[idx] + static_cast<cost_t>(steps));
+        }
+    }
+
+    bool JumpPointSearch::find_path(const BitGrid &blocked,
+                                    std::size_t start, std::size_t goal,
+                                    std::vector<std::size_t> &path)
+    {
+        blocked_ = &blocked;
+        width_ = blocked.width();
+        height_ = blocked.height();
+        goal_ = goal;
+        expanded_ = 0;
+        path.clear();
+
+        const std::size_t size = width_ * height_;
+        if (stamp_.size() != size)
+        {
+            g_.assign(size, UNREACHABLE);
+            prev_.assign(size, NO_NODE);
+            stamp_.assign(size, 0);
+            query_ = 0;
+        }
+        if (++query_ == 0) // stamp wrapped around, forget every old stamp
+        {
+            std::fill(stamp_.begin(), stamp_.end(), 0);
+            query_ = 1;
+        }
+
+        if (blocked.at(goal % width_, goal / width_) || blocked.at(start % width_, start / width_))
+            return false;
+
+        open_set_.clear();
+        visit(start, NO_NODE, 0);
+
+        while (!open_set_.empty())
+        {
+            auto [f, idx] = open_set_.pop();
+            if (f > g_[idx] + heuristic(idx))
+                continue; // stale entry
+
+            ++expanded_;
+            if (idx == goal)
+                break;
+
+            expand(idx);
+        }
+
+        if (stamp_[goal] != query_)
+            return false;
+
+        // Unroll the jump points into individual steps, goal first
+        for (std::size_t idx = goal; idx != start; idx = prev_[idx])
+        {
+            const long px = prev_[idx] % width_, py = prev_[idx] / width_;
+            long x = idx % width_, y = idx / width_;
+            const int dx = sign(px - x), dy = sign(py - y);
+
+            for (; x != px || y != py; x += dx, y += dy)
+                path.push_back(y * width_ + x);
+        }
+        path.push_back(start);
+        std::reverse(path.begin(), path.end());
+        return true;
+    }
+} // namespace Pathing
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "util/grid.hpp"
+#include "util/bit_grid.hpp"
+#include "util/pathing.hpp"
+
+namespace Pathing
+{
+    /**
+     * Jump Point Search for point-to-point queries on a uniform-cost, 8-connected grid
+     * (every move costs 1, diagonals may squeeze between blocked corners like any other
+     * move in the game). Produces the same path lengths as Dijkstra over the same grid
+     * while only expanding jump points.
+     *
+     * The blocked map is read on every query, so it stays valid as long as the caller
+     * keeps it in sync with the terrain; there is no precomputed state to invalidate.
+     * Scratch buffers are stamped per query, so a query only touches the cells it visits.
+     */
+    class JumpPointSearch
+    {
+    public:
+        /**
+         * Find a shortest path from `start` to `goal` (row-major indices into `blocked`).
+         * On success `path` holds every cell from start to goal inclusive.
+         */
+        bool find_path(const BitGrid &blocked,
+                       std::size_t start, std::size_t goal,
+                       std::vector<std::size_t> &path);
+
+        std::size_t expanded() const { return expanded_; }
+
+    private:
+        bool open(long x, long y) const
+        {
+            return x >= 0 && y >= 0 &&
+                   static_cast<std::size_t>(x) < width_ && static_cast<std::size_t>(y) < height_ &&
+                   !blocked_->at(x, y);
+        }
+
+        std::size_t jump(long x, long y, int dx, int dy) const;
+        void expand(std::size_t idx);
+        void visit(std::size_t idx, std::size_t from, cost_t g);
+
+        cost_t heuristic(std::size_t idx) const;
+
+        const BitGrid *blocked_ = nullptr;
+        std::size_t width_ = 0, height_ = 0;
+        std::size_t goal_ = NO_NODE;
+
+        std::vector<cost_t> g_;
+        std::vector<std::size_t> prev_;
+        std::vector<uint32_t> stamp_; // g_/prev_ are only valid where stamp_ == query_
+        uint32_t query_ = 0;
+
+        HeapFrontier open_set_;
+        std::size_t expanded_ = 0;
+    };
+} // namespace Pathing
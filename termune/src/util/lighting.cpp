@@ -0,0 +1,129 @@
+#include "util/lighting.hpp"
+
+#include <algorithm>
+
+namespace Lighting
+{
+    void LightMap::reset(std::size_t width, std::size_t height)
+    {
+        if (levels_.width() == width && levels_.height() == height)
+        {
+            levels_.fill(0); // the next floor is usually the same size
+            counted_.fill(false);
+        }
+        else
+        {
+            levels_ = Grid<level_t>(width, height, 0);
+            counted_ = BitGrid(width, height);
+        }
+        sources_.clear();
+        index_.clear();
+        dirty_.clear();
+    }
+
+    void LightMap::set_source(const void *key, const Source &source)
+    {
+        auto it = index_.find(key);
+        if (it == index_.end())
+        {
+            index_.emplace(key, sources_.size());
+            dirty_.push_back(sources_.size());
+            sources_.push_back({key, source});
+            return;
+        }
+
+        Entry &entry = sources_[it->second];
+        if (entry.source == source)
+            return;
+        entry.source = source;
+        if (!entry.dirty)
+        {
+            entry.dirty = true;
+            dirty_.push_back(it->second);
+        }
+    }
+
+    void LightMap::remove_source(const void *key)
+    {
+        auto it = index_.find(key);
+        if (it == index_.end())
+            return;
+
+        // Its light goes now, the last source takes over its slot
+        const std::size_t slot = it->second;
+        take_back(sources_[slot]);
+        index_.erase(it);
+
+        dirty_.erase(std::remove(dirty_.begin(), dirty_.end(), slot), dirty_.end());
+        const std::size_t last = sources_.size() - 1;
+        if (slot != last)
+        {
+            sources_[slot] = std::move(sources_[last]);
+            index_[sources_[slot].key] = slot;
+            std::replace(dirty_.begin(), dirty_.end(), last, slot);
+        }
+        sources_.pop_back();
+    }
+
+    void LightMap::cell_changed(std::size_t x, std::size_t y)
+    {
+        for (std::size_t i = 0; i < sources_.size(); ++i)
+        {
+            Entry &entry = sources_[i];
+            const Source &s = entry.source;
+            const std::size_t dx = x > s.x ? x - s.x : s.x - x;
+            const std::size_t dy = y > s.y ? y - s.y : s.y - y;
+            if (!entry.dirty && dx <= s.radius && dy <= s.radius)
+            {
+                entry.dirty = true;
+                dirty_.push_back(i);
+            }
+        }
+    }
+
+    bool LightMap::update(const BitGrid &solid_map)
+    {
+        if (dirty_.empty())
+            return false;
+
+        // All the old light goes first, so overlapping sources never see half-updated levels
+        for (std::size_t i : dirty_)
+            take_back(sources_[i]);
+
+        const std::size_t w = levels_.width();
+        for (std::size_t i : dirty_)
+        {
+            Entry &entry = sources_[i];
+            const Source &s = entry.source;
+            const long radius_sq = long(s.radius) * long(s.radius);
+
+            ShadowCast::cast(solid_map, s.x, s.y, s.radius, ws_, [&](std::size_t x, std::size_t y)
+                             {
+                if (counted_.at(x, y)) // cast() may visit a cell twice
+                    return;
+                counted_.set(x, y);
+
+                const long dx = long(x) - long(s.x), dy = long(y) - long(s.y);
+                const long left = radius_sq - (dx * dx + dy * dy); // > 0 except at a radius-0 origin
+                const level_t level = radius_sq ? level_t(1 + (s.brightness - 1) * left / radius_sq) : s.brightness;
+
+                const uint32_t idx = uint32_t(x + y * w);
+                entry.lit.push_back({idx, level});
+                levels_.data()[idx] += level; });
+
+            for (const Lit &l : entry.lit)
+                counted_.set(l.idx % w, l.idx / w, false);
+            entry.dirty = false;
+            ++casts_;
+        }
+        dirty_.clear();
+        return true;
+    }
+
+    void LightMap::take_back(Entry &entry)
+    {
+        for (const Lit &l : entry.lit)
+            levels_.data()[l.idx] -= l.level;
+        entry.lit.clear();
+    }
+} // namespace Lighting
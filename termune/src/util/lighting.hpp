@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <unordered_map>
+
+#include "util/grid.hpp"
+#include "util/bit_grid.hpp"
+#include "util/shadowcast.hpp"
+
+namespace Lighting
+{
+    using level_t = uint16_t;
+    static constexpr level_t MAX_LEVEL = 255;
+
+    struct Source
+    {
+        std::size_t x = 0, y = 0;
+        std::size_t radius = 0;
+        level_t brightness = 1; /**< Level at the source, fading towards 1 at the edge */
+
+        bool operator==(const Source &o) const
+        {
+            return x == o.x && y == o.y && radius == o.radius && brightness == o.brightness;
+        }
+        bool operator!=(const Source &o) const { return !(*this == o); }
+    };
+
+    /**
+     * Light from any number of sources, added up into one level per cell. Every source keeps
+     * the cells it lit, so update() only recasts the sources that were added, moved, removed
+     * or can reach a cell that changed opacity since the last update, and takes the rest as
+     * they are.
+     */
+    class LightMap
+    {
+    public:
+        void reset(std::size_t width, std::size_t height);
+
+        /** Add a source under `key`, or change it. Setting it to what it already is costs nothing. */
+        void set_source(const void *key, const Source &source);
+        void remove_source(const void *key);
+
+        /** (x, y) changed opacity: sources that can reach it are recast on the next update. */
+        void cell_changed(std::size_t x, std::size_t y);
+
+        /** Bring the levels up to date with every change since the last call, true if any. */
+        bool update(const BitGrid &solid_map);
+
+        level_t at(std::size_t x, std::size_t y) const
+        {
+            level_t level = levels_.at(x, y);
+            return level < MAX_LEVEL ? level : MAX_LEVEL;
+        }
+        bool lit(std::size_t x, std::size_t y) const { return levels_.at(x, y) != 0; }
+
+        std::size_t source_count() const { return sources_.size(); }
+        std::size_t casts() const { return casts_; } /**< Sources cast so far */
+
+    private:
+        struct Lit
+        {
+            uint32_t idx;
+            level_t level;
+        };
+
+        struct Entry
+        {
+            const void *key;
+            Source source;
+            bool dirty = true;
+            std::vector<Lit> lit; /**< What it added to levels_, taken back before a recast */
+        };
+
+        void take_back(Entry &entry);
+
+        Grid<level_t> levels_{0, 0}; // may exceed MAX_LEVEL where lights overlap
+        std::vector<Entry> sources_;
+        std::unordered_map<const void *, std::size_t> index_; // key -> sources_ slot
+        std::vector<std::size_t> dirty_;
+        ShadowCast::Workspace ws_;
+        BitGrid counted_{0, 0}; // cells the source being cast has lit, clear between casts
+        std::size_t casts_ = 0;
+    };
+} // namespace Lighting
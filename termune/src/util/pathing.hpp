@@ -1,28 +1,572 @@
 #pragma once
 
-#include <memory>
 #include <vector>
 #include <limits>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+
+#include "util/grid.hpp"
 
 namespace Pathing
 {
-    class Node
+    using cost_t = uint32_t;
+
+    static constexpr cost_t UNREACHABLE = std::numeric_limits<cost_t>::max();
+    static constexpr std::size_t NO_NODE = SIZE_MAX;
+
+    enum class Connectivity
+    {
+        FOUR,  // W, E, N, S
+        EIGHT, // row-major over the 3x3 neighborhood
+    };
+
+    template <Connectivity C>
+    struct Neighborhood;
+
+    template <>
+    struct Neighborhood<Connectivity::FOUR>
+    {
+        static constexpr int count = 4;
+        static constexpr int dx[4] = {-1, 1, 0, 0};
+        static constexpr int dy[4] = {0, 0, -1, 1};
+    };
+
+    template <>
+    struct Neighborhood<Connectivity::EIGHT>
+    {
+        static constexpr int count = 8;
+        static constexpr int dx[8] = {-1, 0, 1, -1, 1, -1, 0, 1};
+        static constexpr int dy[8] = {-1, -1, -1, 0, 0, 1, 1, 1};
+    };
+
+    using Entry = std::pair<cost_t, std::size_t>; // (cost, index)
+
+    /** Binary min-heap frontier, valid for any non-negative step cost. */
+    class HeapFrontier
     {
     public:
-        virtual ~Node() = default;
+        void push(cost_t cost, std::size_t idx)
+        {
+            heap_.emplace_back(cost, idx);
+            std::push_heap(heap_.begin(), heap_.end(), cmp);
+        }
 
-        unsigned long cost = std::numeric_limits<unsigned long>::max(); /**< Cost to reach this node */
-        std::size_t prev = SIZE_MAX;                                    /**< Index of previous node in path */
+        Entry pop()
+        {
+            std::pop_heap(heap_.begin(), heap_.end(), cmp);
+            Entry top = heap_.back();
+            heap_.pop_back();
+            return top;
+        }
 
-        /** Return a list of neighbor indices for this node. */
-        virtual std::vector<std::size_t> get_neighbors() const = 0;
+        bool empty() const { return heap_.empty(); }
+        void clear() { heap_.clear(); }
 
-        /** Return the cost to move from this node to the given neighbor. */
-        virtual unsigned long movement_cost_to(const Node &neighbor) const = 0;
+    private:
+        static bool cmp(const Entry &a, const Entry &b)
+        {
+            return a.first > b.first; // min-heap
+        }
 
-        /** Return true if this node is the goal. */
-        virtual bool is_goal() const = 0;
+        std::vector<Entry> heap_;
     };
 
-    std::vector<size_t> solve(std::vector<std::unique_ptr<Node>> &nodes, size_t start_idx);
+    /**
+     * Monotone bucket queue (Dial's algorithm) for small integer step costs.
+     * Every pushed cost must lie in [last popped cost, last popped cost + max_step],
+     * which holds for Dijkstra whenever no single step costs more than `max_step`.
+     * Push and pop are O(1) amortized, so a full solve is O(V + max cost).
+     */
+    class BucketFrontier
+    {
+    public:
+        explicit BucketFrontier(cost_t max_step = 255) { set_max_step(max_step); }
+
+        void set_max_step(cost_t max_step)
+        {
+            std::size_t n = 1;
+            while (n <= max_step)
+                n <<= 1;
+            buckets_.assign(n, {});
+            mask_ = n - 1;
+            clear();
+        }
+
+        void push(cost_t cost, std::size_t idx)
+        {
+            if (!anchored_)
+            {
+                current_ = cost; // first entry since clear() positions the window
+                anchored_ = true;
+            }
+            else if (cost < current_ || cost - current_ > mask_)
+                throw std::out_of_range("BucketFrontier::push() - cost outside of bucket window");
+            buckets_[cost & mask_].push_back(idx);
+            ++size_;
+        }
+
+        Entry pop()
+        {
+            while (buckets_[current_ & mask_].empty())
+                ++current_;
+
+            auto &bucket = buckets_[current_ & mask_];
+            std::size_t idx = bucket.back();
+            bucket.pop_back();
+            --size_;
+            return {current_, idx};
+        }
+
+        bool empty() const { return size_ == 0; }
+
+        void clear()
+        {
+            for (auto &bucket : buckets_)
+                bucket.clear();
+            size_ = 0;
+            current_ = 0;
+            anchored_ = false;
+        }
+
+    private:
+        std::vector<std::vector<std::size_t>> buckets_; // ring of buckets, one cost each
+        std::size_t mask_ = 0;
+        std::size_t size_ = 0;
+        cost_t current_ = 0;
+        bool anchored_ = false;
+    };
+
+    /**
+     * Scratch state reused between solves. Buffers are only reallocated when the grid
+     * dimensions change, so repeated solves on the same map do not allocate.
+     */
+    template <typename Frontier>
+    class BasicWorkspace
+    {
+    public:
+        template <typename... FrontierArgs>
+        explicit BasicWorkspace(FrontierArgs &&...args)
+            : prev(0, 0), frontier(std::forward<FrontierArgs>(args)...) {}
+
+        void reset(std::size_t width, std::size_t height)
+        {
+            if (prev.width() != width || prev.height() != height)
+                prev = Grid<std::size_t>(width, height, NO_NODE);
+            else
+                prev.fill(NO_NODE);
+
+            frontier.clear();
+            expanded = 0;
+        }
+
+    public:
+        Grid<std::size_t> prev;         /**< Index of previous node in path */
+        Frontier frontier;              /**< Open set of (cost, index) entries */
+        std::size_t expanded = 0;       /**< Nodes expanded by the last solve */
+        std::vector<std::size_t> stack; /**< Scratch for repair_increase() */
+    };
+
+    using Workspace = BasicWorkspace<HeapFrontier>;
+    using BucketWorkspace = BasicWorkspace<BucketFrontier>;
+
+    struct NoGoal
+    {
+        bool operator()(std::size_t) const { return false; }
+    };
+
+    namespace detail
+    {
+        // Dijkstra main loop, stops after `budget` expansions. Returns true once the frontier
+        // ran dry or a goal was settled (stored in `goal`).
+        template <Connectivity C, typename Frontier, typename StepCost, typename IsGoal>
+        bool run_dijkstra(BasicWorkspace<Frontier> &ws, Grid<cost_t> &dist,
+                          StepCost &step_cost, IsGoal &is_goal,
+                          std::size_t budget, std::size_t &goal)
+        {
+            using N = Neighborhood<C>;
+
+            const std::size_t w = dist.width();
+            const std::size_t h = dist.height();
+
+            cost_t *d = dist.data();
+            std::size_t *prev = ws.prev.data();
+
+            goal = NO_NODE;
+            for (std::size_t done = 0; !ws.frontier.empty(); ++done)
+            {
+                if (done == budget)
+                    return false;
+
+                auto [curr_cost, curr_idx] = ws.frontier.pop();
+                if (curr_cost > d[curr_idx])
+                    continue; // stale entry, already settled with a lower cost
+
+                ++ws.expanded;
+                if (is_goal(curr_idx))
+                {
+                    goal = curr_idx;
+                    return true;
+                }
+
+                const std::size_t x = curr_idx % w;
+                const std::size_t y = curr_idx / w;
+
+                for (int i = 0; i < N::count; ++i)
+                {
+                    std::size_t nx = x + N::dx[i];
+                    std::size_t ny = y + N::dy[i];
+                    if (nx >= w || ny >= h)
+                        continue;
+
+                    std::size_t n_idx = ny * w + nx;
+                    cost_t step = step_cost(curr_idx, n_idx);
+                    if (step == UNREACHABLE)
+                        continue;
+
+                    cost_t new_cost = curr_cost + step;
+                    if (new_cost < d[n_idx])
+                    {
+                        d[n_idx] = new_cost;
+                        prev[n_idx] = curr_idx;
+                        ws.frontier.push(new_cost, n_idx);
+                    }
+                }
+            }
+            return true;
+        }
+    } // namespace detail
+
+    /**
+     * Resumable form of solve(): solve_begin() sets up the search, then each solve_resume()
+     * expands at most `budget` nodes and returns true once the map is complete. `ws` and
+     * `dist` hold all the state in between, so neither may be touched until then. Step costs
+     * may only drop between calls; cells that did should be fixed with repair_decrease()
+     * once the solve is complete.
+     */
+    template <typename Frontier>
+    void solve_begin(BasicWorkspace<Frontier> &ws, Grid<cost_t> &dist, std::size_t start)
+    {
+        ws.reset(dist.width(), dist.height());
+        dist.fill(UNREACHABLE);
+
+        dist.data()[start] = 0;
+        ws.frontier.push(0, start);
+    }
+
+    /** Same as above with every cell of `sources` at cost 0, for maps towards the nearest of many goals. */
+    template <typename Frontier>
+    void solve_begin(BasicWorkspace<Frontier> &ws, Grid<cost_t> &dist, const std::vector<std::size_t> &sources)
+    {
+        ws.reset(dist.width(), dist.height());
+        dist.fill(UNREACHABLE);
+
+        for (std::size_t source : sources)
+        {
+            dist.data()[source] = 0;
+            ws.frontier.push(0, source);
+        }
+    }
+
+    template <Connectivity C = Connectivity::EIGHT, typename Frontier, typename StepCost>
+    bool solve_resume(BasicWorkspace<Frontier> &ws, Grid<cost_t> &dist,
+                      StepCost &&step_cost, std::size_t budget)
+    {
+        NoGoal no_goal;
+        std::size_t goal;
+        return detail::run_dijkstra<C>(ws, dist, step_cost, no_goal, budget, goal);
+    }
+
+    /**
+     * Dijkstra over a row-major grid. `step_cost(from, to)` returns the cost of entering
+     * `to` from `from`, or UNREACHABLE if the move is not allowed. `is_goal(idx)` stops the
+     * search early when it returns true for a settled node.
+     *
+     * `dist` receives the cost to reach every settled cell (UNREACHABLE elsewhere).
+     * Returns the goal index, or NO_NODE if no goal was reached.
+     */
+    template <Connectivity C = Connectivity::EIGHT, typename Frontier, typename StepCost, typename IsGoal = NoGoal>
+    std::size_t solve(BasicWorkspace<Frontier> &ws, Grid<cost_t> &dist, std::size_t start,
+                      StepCost &&step_cost, IsGoal &&is_goal = IsGoal())
+    {
+        solve_begin(ws, dist, start);
+
+        std::size_t goal;
+        detail::run_dijkstra<C>(ws, dist, step_cost, is_goal, SIZE_MAX, goal);
+        return goal;
+    }
+
+    /**
+     * A* from `start` to `goal`. `heuristic(idx)` must never overestimate the remaining cost
+     * and must be consistent (drop by at most the step cost per move); with such a heuristic
+     * the returned path is optimal and every node is expanded at most once.
+     *
+     * `dist` receives the cost from `start` for every cell reached (UNREACHABLE elsewhere).
+     * Returns `goal`, or NO_NODE if it cannot be reached.
+     */
+    template <Connectivity C = Connectivity::EIGHT, typename Frontier, typename StepCost, typename Heuristic>
+    std::size_t solve_astar(BasicWorkspace<Frontier> &ws, Grid<cost_t> &dist,
+                            std::size_t start, std::size_t goal,
+                            StepCost &&step_cost, Heuristic &&heuristic)
+    {
+        using N = Neighborhood<C>;
+
+        const std::size_t w = dist.width();
+        const std::size_t h = dist.height();
+
+        ws.reset(w, h);
+        dist.fill(UNREACHABLE);
+
+        cost_t *d = dist.data();
+        std::size_t *prev = ws.prev.data();
+
+        d[start] = 0;
+        ws.frontier.push(heuristic(start), start);
+
+        while (!ws.frontier.empty())
+        {
+            auto [curr_f, curr_idx] = ws.frontier.pop();
+            const cost_t curr_cost = d[curr_idx];
+            if (curr_f > curr_cost + heuristic(curr_idx))
+                continue; // stale entry
+
+            ++ws.expanded;
+            if (curr_idx == goal)
+                return goal;
+
+            const std::size_t x = curr_idx % w;
+            const std::size_t y = curr_idx / w;
+
+            for (int i = 0; i < N::count; ++i)
+            {
+                std::size_t nx = x + N::dx[i];
+                std::size_t ny = y + N::dy[i];
+                if (nx >= w || ny >= h)
+                    continue;
+
+                std::size_t n_idx = ny * w + nx;
+                cost_t step = step_cost(curr_idx, n_idx);
+                if (step == UNREACHABLE)
+                    continue;
+
+                cost_t new_cost = curr_cost + step;
+                if (new_cost < d[n_idx])
+                {
+                    d[n_idx] = new_cost;
+                    prev[n_idx] = curr_idx;
+                    ws.frontier.push(new_cost + heuristic(n_idx), n_idx);
+                }
+            }
+        }
+        return NO_NODE;
+    }
+
+    /**
+     * Repair a distance map produced by `solve` after the cost of stepping into `idx`
+     * decreased (e.g. rock was mined or became open). Only cells whose cost actually drops
+     * are expanded, so a local change costs O(affected region) instead of a full solve.
+     *
+     * Costs never increase in this repair; if a step cost rises, re-run `solve` instead.
+     * Returns the number of expanded nodes.
+     */
+    template <Connectivity C = Connectivity::EIGHT, typename Frontier, typename StepCost>
+    std::size_t repair_decrease(BasicWorkspace<Frontier> &ws, Grid<cost_t> &dist, std::size_t idx,
+                                StepCost &&step_cost)
+    {
+        using N = Neighborhood<C>;
+
+        const std::size_t w = dist.width();
+        const std::size_t h = dist.height();
+
+        if (ws.prev.width() != w || ws.prev.height() != h)
+            ws.reset(w, h);
+        ws.frontier.clear();
+        ws.expanded = 0;
+
+        cost_t *d = dist.data();
+        std::size_t *prev = ws.prev.data();
+
+        // Re-derive the changed cell from its neighbors
+        std::size_t x = idx % w;
+        std::size_t y = idx / w;
+        for (int i = 0; i < N::count; ++i)
+        {
+            std::size_t nx = x + N::dx[i];
+            std::size_t ny = y + N::dy[i];
+            if (nx >= w || ny >= h)
+                continue;
+
+            std::size_t n_idx = ny * w + nx;
+            if (d[n_idx] == UNREACHABLE)
+                continue;
+
+            cost_t step = step_cost(n_idx, idx);
+            if (step != UNREACHABLE && d[n_idx] + step < d[idx])
+            {
+                d[idx] = d[n_idx] + step;
+                prev[idx] = n_idx;
+            }
+        }
+
+        if (d[idx] == UNREACHABLE)
+            return 0;
+
+        // Propagate the decrease outward; only improved cells re-enter the frontier
+        ws.frontier.push(d[idx], idx);
+        while (!ws.frontier.empty())
+        {
+            auto [curr_cost, curr_idx] = ws.frontier.pop();
+            if (curr_cost > d[curr_idx])
+                continue;
+
+            ++ws.expanded;
+            x = curr_idx % w;
+            y = curr_idx / w;
+
+            for (int i = 0; i < N::count; ++i)
+            {
+                std::size_t nx = x + N::dx[i];
+                std::size_t ny = y + N::dy[i];
+                if (nx >= w || ny >= h)
+                    continue;
+
+                std::size_t n_idx = ny * w + nx;
+                cost_t step = step_cost(curr_idx, n_idx);
+                if (step == UNREACHABLE)
+                    continue;
+
+                cost_t new_cost = curr_cost + step;
+                if (new_cost < d[n_idx])
+                {
+                    d[n_idx] = new_cost;
+                    prev[n_idx] = curr_idx;
+                    ws.frontier.push(new_cost, n_idx);
+                }
+            }
+        }
+        return ws.expanded;
+    }
+
+    /**
+     * Make `idx` an extra source (cost 0) of a map produced by `solve`, propagating the
+     * decrease like repair_decrease(). Returns the number of expanded nodes.
+     */
+    template <Connectivity C = Connectivity::EIGHT, typename Frontier, typename StepCost>
+    std::size_t repair_add_source(BasicWorkspace<Frontier> &ws, Grid<cost_t> &dist, std::size_t idx,
+                                  StepCost &&step_cost)
+    {
+        if (ws.prev.width() != dist.width() || ws.prev.height() != dist.height())
+            ws.reset(dist.width(), dist.height());
+        ws.frontier.clear();
+        ws.expanded = 0;
+
+        dist.data()[idx] = 0;
+        ws.prev.data()[idx] = NO_NODE;
+        ws.frontier.push(0, idx);
+
+        NoGoal no_goal;
+        std::size_t goal;
+        detail::run_dijkstra<C>(ws, dist, step_cost, no_goal, SIZE_MAX, goal);
+        return ws.expanded;
+    }
+
+    /**
+     * Repair a map after the cost of stepping into `idx` rose, or `idx` stopped being a
+     * source. Every cell whose shortest path ran through `idx` (its subtree in `ws.prev`)
+     * is cleared and re-derived from the cells around it, so `ws` must be the workspace
+     * that solved and repaired `dist` so far. Other sources keep their cost of 0.
+     *
+     * The re-derived cells start out at unrelated costs, so this needs a HeapFrontier.
+     * Returns the number of expanded nodes.
+     */
+    template <Connectivity C = Connectivity::EIGHT, typename StepCost>
+    std::size_t repair_increase(BasicWorkspace<HeapFrontier> &ws, Grid<cost_t> &dist, std::size_t idx,
+                                StepCost &&step_cost)
+    {
+        using N = Neighborhood<C>;
+
+        const std::size_t w = dist.width();
+        const std::size_t h = dist.height();
+
+        ws.frontier.clear();
+        ws.expanded = 0;
+
+        cost_t *d = dist.data();
+        std::size_t *prev = ws.prev.data();
+
+        // Collect the subtree hanging off idx, clearing it on the way
+        std::vector<std::size_t> &affected = ws.stack;
+        affected.clear();
+        affected.push_back(idx);
+        d[idx] = UNREACHABLE;
+        prev[idx] = NO_NODE;
+        for (std::size_t i = 0; i < affected.size(); ++i)
+        {
+            std::size_t x = affected[i] % w;
+            std::size_t y = affected[i] / w;
+            for (int k = 0; k < N::count; ++k)
+            {
+                std::size_t nx = x + N::dx[k];
+                std::size_t ny = y + N::dy[k];
+                if (nx >= w || ny >= h)
+                    continue;
+
+                std::size_t n_idx = ny * w + nx;
+                if (prev[n_idx] == affected[i])
+                {
+                    d[n_idx] = UNREACHABLE;
+                    prev[n_idx] = NO_NODE;
+                    affected.push_back(n_idx);
+                }
+            }
+        }
+
+        // Re-derive each one from the cells left intact, then let Dijkstra fill the rest in
+        for (std::size_t a : affected)
+        {
+            std::size_t x = a % w;
+            std::size_t y = a / w;
+            for (int k = 0; k < N::count; ++k)
+            {
+                std::size_t nx = x + N::dx[k];
+                std::size_t ny = y + N::dy[k];
+                if (nx >= w || ny >= h)
+                    continue;
+
+                std::size_t n_idx = ny * w + nx;
+                if (d[n_idx] == UNREACHABLE)
+                    continue;
+
+                cost_t step = step_cost(n_idx, a);
+                if (step != UNREACHABLE && d[n_idx] + step < d[a])
+                {
+                    d[a] = d[n_idx] + step;
+                    prev[a] = n_idx;
+                }
+            }
+            if (d[a] != UNREACHABLE)
+                ws.frontier.push(d[a], a);
+        }
+
+        NoGoal no_goal;
+        std::size_t goal;
+        detail::run_dijkstra<C>(ws, dist, step_cost, no_goal, SIZE_MAX, goal);
+        return ws.expanded;
+    }
+
+    /** Write the path ending at `goal` (start first) into `out`, reusing its storage. */
+    template <typename Frontier>
+    void trace_path(const BasicWorkspace<Frontier> &ws, std::size_t goal, std::vector<std::size_t> &out)
+    {
+        out.clear();
+        if (goal == NO_NODE)
+            return;
+
+        const std::size_t *prev = ws.prev.data();
+        for (std::size_t i = goal; i != NO_NODE; i = prev[i])
+            out.push_back(i);
+        std::reverse(out.begin(), out.end());
+    }
 } // namespace Pathing
@@ -1,142 +1,135 @@
 #include "util/shadowcast.hpp"
 
-#include <cmath>
-#include <cstdio>
-#include <algorithm>
+#include <stdexcept>
 
 namespace ShadowCast
 {
-    static constexpr float EPSILON = 0.0001f;
-
-    // Octant transformation matrix
-    static const int MULT[4][8] = {
-        {1, 0, 0, -1, -1, 0, 0, 1}, // xx
-        {0, 1, -1, 0, 0, -1, 1, 0}, // xy
-        {0, 1, 1, 0, 0, -1, -1, 0}, // yx
-        {1, 0, 0, 1, -1, 0, 0, -1}  // yy
-    };
-
-    // Checks if a cell is outside the map or blocks light
-    inline bool is_blocked(const Grid<unsigned char> &solid_map, int x, int y)
-    {
-        return static_cast<std::size_t>(x) >= solid_map.width() ||
-               static_cast<std::size_t>(y) >= solid_map.height() ||
-               solid_map(x, y);
-    }
+    // cast_mask() remembers this many window patterns per workspace, 16 KiB
+    static constexpr std::size_t PATTERN_BITS = 10;
 
-    // Marks a cell as visible in the lightmap
-    inline void set_visible(Lightmap &map, int x, int y)
+    uint64_t cast_mask(const BitGrid &solid_map, std::size_t origin_x, std::size_t origin_y,
+                       std::size_t radius, Workspace &ws)
     {
-        if (static_cast<std::size_t>(x) < map.width() &&
-            static_cast<std::size_t>(y) < map.height())
-        {
-            map(x, y) = true;
-        }
+        Window &window = ws.window;
+        window.min_x = origin_x - std::min(origin_x, radius);
+        window.min_y = origin_y - std::min(origin_y, radius);
+        window.max_x = std::min(solid_map.width(), origin_x + radius + 1);
+        window.max_y = std::min(solid_map.height(), origin_y + radius + 1);
+
+        // A window has at most 49 cells, the radius and a used flag go in the bits above
+        const uint64_t opaque = detail::window_mask(solid_map, origin_x, origin_y, radius);
+        const uint64_t key = opaque | uint64_t(radius) << 56 | uint64_t(1) << 63;
+
+        if (ws.patterns.empty())
+            ws.patterns.resize(std::size_t(1) << PATTERN_BITS);
+        Workspace::Pattern &pattern = ws.patterns[(key * 0x9E3779B97F4A7C15ull) >> (64 - PATTERN_BITS)];
+        if (pattern.key == key)
+            return pattern.lit;
+
+        // Cast inside the window alone, the origin at its center
+        const int side = static_cast<int>(2 * radius + 1), r = static_cast<int>(radius);
+        uint64_t lit = uint64_t(1) << (r * side + r);
+        auto blocked_at = [&](int x, int y)
+        { return (opaque >> (y * side + x)) & 1; };
+        auto visit = [&](std::size_t x, std::size_t y)
+        { lit |= uint64_t(1) << (y * side + x); };
+        for (int oct = 0; oct < 8; ++oct)
+            detail::cast_octant(blocked_at, r, r, r,
+                                detail::MULT[0][oct], detail::MULT[1][oct],
+                                detail::MULT[2][oct], detail::MULT[3][oct],
+                                ws.stack, visit);
+
+        pattern = {key, lit};
+        return lit;
     }
 
-    // Recursive shadowcasting function
-    static void cast_light(
-        const Grid<unsigned char> &solid_map,
+    void update_lightmap(
+        const BitGrid &solid_map,
         Lightmap &visible,
-        int origin_x, int origin_y,
-        int row,
-        float start_slope, float end_slope,
+        std::size_t origin_x,
+        std::size_t origin_y,
         std::size_t radius,
-        int xx, int xy, int yx, int yy)
+        Workspace &ws)
     {
-        if (start_slope < end_slope)
-            return;
+        // Only the last window can hold anything lit
+        const Window &window = ws.window;
+        for (std::size_t y = window.min_y; y < window.max_y; ++y)
+            visible.fill_span(y, window.min_x, window.max_x, false);
 
-        int radius_sq = static_cast<int>(radius * radius);
-
-        for (int j = row; static_cast<std::size_t>(j) <= radius; ++j)
+        // Small windows are lit as one mask and stored a row at a time, not cell by cell
+        if (radius <= detail::MASK_RADIUS && origin_x < solid_map.width() && origin_y < solid_map.height())
         {
-            int dx = -j - 1;
-            int dy = -j;
-            bool blocked = false;
-            float new_start_slope = start_slope;
-
-            while (dx <= 0)
+            const uint64_t lit = cast_mask(solid_map, origin_x, origin_y, radius, ws);
+            const std::size_t side = 2 * radius + 1;
+            const std::size_t shift = window.min_x + radius - origin_x; // columns off the left edge
+            for (std::size_t y = window.min_y; y < window.max_y; ++y)
             {
-                ++dx;
-
-                int X = origin_x + dx * xx + dy * xy;
-                int Y = origin_y + dx * yx + dy * yy;
-
-                float l_slope = (dx - 0.5f) / (dy + 0.5f);
-                float r_slope = (dx + 0.5f) / (dy - 0.5f);
-
-                if (start_slope + EPSILON < r_slope)
-                    continue;
-                if (end_slope - EPSILON > l_slope)
-                    break;
-
-                int dist_sq = dx * dx + dy * dy;
-                if (dist_sq < radius_sq)
-                {
-                    if (!is_blocked(solid_map, X, Y))
-                    {
-                        set_visible(visible, X, Y);
-                    }
-                }
-
-                if (blocked)
-                {
-                    if (is_blocked(solid_map, X, Y))
-                    {
-                        new_start_slope = r_slope;
-                        continue;
-                    }
-                    else
-                    {
-                        blocked = false;
-                        start_slope = new_start_slope;
-                    }
-                }
-                else if (is_blocked(solid_map, X, Y))
-                {
-                    blocked = true;
-                    cast_light(solid_map, visible, origin_x, origin_y,
-                               j + 1, start_slope, l_slope, radius,
-                               xx, xy, yx, yy);
-                    new_start_slope = r_slope;
-                }
+                const uint64_t row = lit >> ((y + radius - origin_y) * side);
+                visible.set_bits(window.min_x, y, (row & ((uint64_t(1) << side) - 1)) >> shift);
             }
-
-            if (blocked)
-                break;
+            return;
         }
+
+        cast(solid_map, origin_x, origin_y, radius, ws, [&](std::size_t x, std::size_t y)
+             { visible.set(x, y); });
     }
 
     void update_lightmap(
-        const Grid<unsigned char> &solid_map,
+        const BitGrid &solid_map,
         Lightmap &visible,
         std::size_t origin_x,
         std::size_t origin_y,
-        std::size_t radius = 0)
+        std::size_t radius)
     {
         visible.fill(false); // Clear previous visibility
 
-        set_visible(visible, static_cast<int>(origin_x), static_cast<int>(origin_y)); // Light source is always visible
-
-        for (int oct = 0; oct < 8; ++oct)
-        {
-            cast_light(solid_map, visible,
-                       static_cast<int>(origin_x), static_cast<int>(origin_y),
-                       1, 1.0f, 0.0f, radius,
-                       MULT[0][oct], MULT[1][oct],
-                       MULT[2][oct], MULT[3][oct]);
-        }
+        Workspace ws;
+        cast(solid_map, origin_x, origin_y, radius, ws, [&](std::size_t x, std::size_t y)
+             { visible.set(x, y); });
     }
 
     Lightmap solve_lightmap(
-        const Grid<unsigned char> &solid_map,
+        const BitGrid &solid_map,
         std::size_t origin_x,
         std::size_t origin_y,
-        std::size_t radius = 0)
+        std::size_t radius)
     {
         Lightmap result(solid_map.width(), solid_map.height(), false);
         update_lightmap(solid_map, result, origin_x, origin_y, radius);
         return result;
     }
+
+    void Table::reset(std::size_t width, std::size_t height, std::size_t radius)
+    {
+        if (radius > MAX_RADIUS)
+            throw std::invalid_argument("ShadowCast::Table - radius too large for a mask");
+
+        width_ = width;
+        height_ = height;
+        radius_ = radius;
+        masks_.assign(width * height, 0);
+        known_ = BitGrid(width, height);
+    }
+
+    void Table::build(const BitGrid &solid_map)
+    {
+        for (std::size_t y = 0; y < height_; ++y)
+            for (std::size_t x = 0; x < width_; ++x)
+                mask(solid_map, x, y);
+    }
+
+    void Table::cell_changed(std::size_t x, std::size_t y)
+    {
+        // Casts never look past `radius` rows in any octant, so only origins this close can see it
+        const std::size_t min_x = x - std::min(x, radius_), max_x = std::min(width_, x + radius_ + 1);
+        const std::size_t min_y = y - std::min(y, radius_), max_y = std::min(height_, y + radius_ + 1);
+        for (std::size_t cy = min_y; cy < max_y; ++cy)
+            known_.fill_span(cy, min_x, max_x, false);
+    }
+
+    Table::mask_t Table::compute(const BitGrid &solid_map, std::size_t origin_x, std::size_t origin_y)
+    {
+        ++computed_;
+        return cast_mask(solid_map, origin_x, origin_y, radius_, ws_);
+    }
 } // namespace ShadowCast
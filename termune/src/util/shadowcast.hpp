@@ -1,25 +1,396 @@
 #pragma once
 
+#include <vector>
 #include <cstddef>
-#include "util/grid.hpp"
+#include <algorithm>
+#include <cstdint>
+#include "util/bit_grid.hpp"
 
 namespace ShadowCast
 {
-    using Lightmap = Grid<unsigned char>;
+    using Lightmap = BitGrid;
+
+    /** Slope num / den of a line through the origin, den > 0. Kept exact so no epsilon is needed. */
+    struct Slope
+    {
+        int num, den;
+    };
+
+    /** Rows still to be scanned in one octant or quadrant, from `row` outwards between two slopes. */
+    struct Span
+    {
+        int row;
+        Slope start, end;
+    };
+
+    /** Cells [min_x, max_x) x [min_y, max_y). */
+    struct Window
+    {
+        std::size_t min_x = 0, min_y = 0, max_x = 0, max_y = 0;
+    };
+
+    /**
+     * Scratch reused between updates of the same lightmap: the pending spans, the window
+     * around the last origin, which is all the next update has to clear, and cast_mask()'s
+     * results by window opacity.
+     */
+    struct Workspace
+    {
+        struct Pattern
+        {
+            uint64_t key = 0, lit = 0;
+        };
+
+        std::vector<Span> stack;
+        Window window;
+        std::vector<Pattern> patterns; // direct-mapped, allocated by the first cast_mask()
+    };
+
+    namespace detail
+    {
+        // Octant transformation matrix
+        inline constexpr int MULT[4][8] = {
+            {1, 0, 0, -1, -1, 0, 0, 1}, // xx
+            {0, 1, -1, 0, 0, -1, 1, 0}, // xy
+            {0, 1, 1, 0, 0, -1, -1, 0}, // yx
+            {1, 0, 0, 1, -1, 0, 0, -1}  // yy
+        };
+
+        // Checks if a cell is outside the map or blocks light
+        inline bool is_blocked(const BitGrid &solid_map, int x, int y)
+        {
+            return static_cast<std::size_t>(x) >= solid_map.width() ||
+                   static_cast<std::size_t>(y) >= solid_map.height() ||
+                   solid_map(x, y);
+        }
+
+        // a < b, both denominators positive
+        inline bool less(Slope a, Slope b)
+        {
+            return a.num * b.den < b.num * a.den;
+        }
+
+        // Largest radius whose (2 * radius + 1)^2 window fits in one 64-bit mask
+        inline constexpr std::size_t MASK_RADIUS = 3;
+
+        /**
+         * Opacity of the window around the origin, bit (dy + radius) * side + (dx + radius) for
+         * the cell at (origin + dx, origin + dy). Cells off the map are opaque, like is_blocked().
+         */
+        inline uint64_t window_mask(const BitGrid &solid_map, std::size_t origin_x, std::size_t origin_y,
+                                    std::size_t radius)
+        {
+            const std::size_t side = 2 * radius + 1;
+            const uint64_t full_row = (uint64_t(1) << side) - 1;
+            const std::size_t min_x = origin_x - std::min(origin_x, radius);
+            const std::size_t max_x = std::min(solid_map.width(), origin_x + radius + 1);
+            const std::size_t shift = min_x + radius - origin_x; // columns off the left edge
+            const uint64_t on_map = ((uint64_t(1) << (max_x - min_x)) - 1) << shift;
+
+            uint64_t mask = ~uint64_t(0);
+            for (std::size_t row = 0; row < side; ++row)
+            {
+                const std::size_t y = origin_y + row - radius; // wraps past the top, like x
+                if (y >= solid_map.height())
+                    continue;
+                const uint64_t cells = solid_map.bits(min_x, y, max_x - min_x) << shift;
+                mask &= ~((full_row & on_map) << (row * side));
+                mask |= cells << (row * side);
+            }
+            return mask;
+        }
+
+        /**
+         * One octant, every shadow-splitting wall pushes the rows behind it instead of recursing.
+         * `blocked(x, y)` answers for cells within `radius` of the origin.
+         */
+        template <typename Blocked, typename Visit>
+        void cast_octant(const Blocked &blocked_at, int origin_x, int origin_y, int radius,
+                         int xx, int xy, int yx, int yy, std::vector<Span> &stack, Visit &visit)
+        {
+            const int radius_sq = radius * radius;
+
+            stack.clear();
+            stack.push_back({1, {1, 1}, {0, 1}});
+            while (!stack.empty())
+            {
+                Span span = stack.back();
+                stack.pop_back();
+
+                Slope start = span.start;
+                const Slope end = span.end;
+                if (less(start, end))
+                    continue;
+
+                for (int j = span.row; j <= radius; ++j)
+                {
+                    const int dy = -j;
+                    bool blocked = false;
+                    Slope new_start = start;
+
+                    for (int dx = -j; dx <= 0; ++dx)
+                    {
+                        int X = origin_x + dx * xx + dy * xy;
+                        int Y = origin_y + dx * yx + dy * yy;
+
+                        // Slopes of the cell's far corners, (dx -+ 0.5) / (dy +- 0.5) with both halves doubled
+                        Slope l_slope = {1 - 2 * dx, 2 * j - 1};
+                        Slope r_slope = {-1 - 2 * dx, 2 * j + 1};
+
+                        if (less(start, r_slope))
+                            continue;
+                        if (less(l_slope, end))
+                            break;
+
+                        const bool wall = blocked_at(X, Y);
+                        if (dx * dx + dy * dy < radius_sq && !wall)
+                            visit(static_cast<std::size_t>(X), static_cast<std::size_t>(Y));
+
+                        if (blocked)
+                        {
+                            if (wall)
+                            {
+                                new_start = r_slope;
+                                continue;
+                            }
+                            blocked = false;
+                            start = new_start;
+                        }
+                        else if (wall)
+                        {
+                            blocked = true;
+                            stack.push_back({j + 1, start, l_slope});
+                            new_start = r_slope;
+                        }
+                    }
+
+                    if (blocked)
+                        break;
+                }
+            }
+        }
+
+        // floor(a / b) for b > 0
+        inline int floor_div(int a, int b)
+        {
+            return a >= 0 ? a / b : -((-a + b - 1) / b);
+        }
+
+        /**
+         * One quadrant of symmetric shadowcasting: a row spans start <= col / depth <= end, and
+         * a floor cell only counts as seen when its center lies inside that span, so cells see
+         * each other both ways. Quadrants are 0 north, 1 east, 2 south, 3 west.
+         */
+        template <typename Visit>
+        void cast_quadrant(const BitGrid &solid_map, int origin_x, int origin_y, int radius,
+                           int quadrant, std::vector<Span> &stack, Visit &visit)
+        {
+            const int radius_sq = radius * radius;
+            auto cell = [&](int depth, int col, int &x, int &y)
+            {
+                x = origin_x + (quadrant % 2 ? (quadrant == 1 ? depth : -depth) : col);
+                y = origin_y + (quadrant % 2 ? col : (quadrant == 0 ? -depth : depth));
+            };
+
+            stack.clear();
+            stack.push_back({1, {-1, 1}, {1, 1}});
+            while (!stack.empty())
+            {
+                Span span = stack.back();
+                stack.pop_back();
+
+                const int depth = span.row;
+                if (depth > radius)
+                    continue;
+
+                // Columns whose centers round into [start, end], ties widening the row
+                const int min_col = floor_div(2 * depth * span.start.num + span.start.den, 2 * span.start.den);
+                const int max_col = -floor_div(span.end.den - 2 * depth * span.end.num, 2 * span.end.den);
+
+                int prev = -1; // -1 before the first cell, then whether the last one was a wall
+                for (int col = min_col; col <= max_col; ++col)
+                {
+                    int X, Y;
+                    cell(depth, col, X, Y);
+                    const bool wall = is_blocked(solid_map, X, Y);
+
+                    const bool centered = col * span.start.den >= depth * span.start.num &&
+                                          col * span.end.den <= depth * span.end.num;
+                    if (!wall && centered && col * col + depth * depth < radius_sq)
+                        visit(static_cast<std::size_t>(X), static_cast<std::size_t>(Y));
+
+                    // Left edge of the cell, (col - 0.5) / depth
+                    const Slope edge = {2 * col - 1, 2 * depth};
+                    if (prev == 1 && !wall)
+                        span.start = edge;
+                    if (prev == 0 && wall)
+                        stack.push_back({depth + 1, span.start, edge});
+                    prev = wall;
+                }
+
+                if (prev == 0)
+                    stack.push_back({depth + 1, span.start, span.end});
+            }
+        }
+    } // namespace detail
+
+    /**
+     * Calls `visit(x, y)` for every cell lit from the origin, some of them more than once,
+     * and stores the window they all lie in as `ws.window`. Nothing is cleared, so callers
+     * keeping their own visibility layer can write it directly.
+     */
+    template <typename Visit>
+    void cast(const BitGrid &solid_map, std::size_t origin_x, std::size_t origin_y,
+              std::size_t radius, Workspace &ws, Visit &&visit)
+    {
+        Window &window = ws.window;
+        window.min_x = origin_x - std::min(origin_x, radius);
+        window.min_y = origin_y - std::min(origin_y, radius);
+        window.max_x = std::min(solid_map.width(), origin_x + radius + 1);
+        window.max_y = std::min(solid_map.height(), origin_y + radius + 1);
+
+        if (origin_x < solid_map.width() && origin_y < solid_map.height())
+            visit(origin_x, origin_y); // Light source is always visible
+
+        auto blocked_at = [&](int x, int y)
+        { return detail::is_blocked(solid_map, x, y); };
+        for (int oct = 0; oct < 8; ++oct)
+        {
+            detail::cast_octant(blocked_at,
+                                static_cast<int>(origin_x), static_cast<int>(origin_y),
+                                static_cast<int>(radius),
+                                detail::MULT[0][oct], detail::MULT[1][oct],
+                                detail::MULT[2][oct], detail::MULT[3][oct],
+                                ws.stack, visit);
+        }
+    }
+
+    /**
+     * cast() for a radius up to detail::MASK_RADIUS from an origin on the map, returning the lit
+     * cells as one mask over the window, laid out like window_mask(), instead of visiting them.
+     * What is lit only depends on the window's opacity, so results are kept by that pattern in
+     * `ws` and a floor's repeated rooms and corridors are cast once each.
+     */
+    uint64_t cast_mask(const BitGrid &solid_map, std::size_t origin_x, std::size_t origin_y,
+                       std::size_t radius, Workspace &ws);
+
+    /**
+     * Same contract as cast(), but symmetric: when it lights (x, y) from the origin, a cast from
+     * (x, y) lights the origin too. Lights fewer cells than cast() around pillars and corners.
+     */
+    template <typename Visit>
+    void cast_symmetric(const BitGrid &solid_map, std::size_t origin_x, std::size_t origin_y,
+                        std::size_t radius, Workspace &ws, Visit &&visit)
+    {
+        Window &window = ws.window;
+        window.min_x = origin_x - std::min(origin_x, radius);
+        window.min_y = origin_y - std::min(origin_y, radius);
+        window.max_x = std::min(solid_map.width(), origin_x + radius + 1);
+        window.max_y = std::min(solid_map.height(), origin_y + radius + 1);
+
+        if (origin_x < solid_map.width() && origin_y < solid_map.height())
+            visit(origin_x, origin_y);
+
+        for (int quadrant = 0; quadrant < 4; ++quadrant)
+            detail::cast_quadrant(solid_map, static_cast<int>(origin_x), static_cast<int>(origin_y),
+                                  static_cast<int>(radius), quadrant, ws.stack, visit);
+    }
+
+    /**
+     * The cells cast() lights from every origin, for one small radius, each stored as a mask over
+     * the (2 * radius + 1)^2 window around its origin. An origin's mask is computed the first
+     * time it is asked for and kept until a cell within `radius` of it changes opacity, so a
+     * floor costs one cast per cell the player actually stands on.
+     */
+    class Table
+    {
+    public:
+        using mask_t = uint64_t;
+        static constexpr std::size_t MAX_RADIUS = detail::MASK_RADIUS; // 7x7 window, 49 bits
+
+        Table() = default;
+        Table(std::size_t width, std::size_t height, std::size_t radius) { reset(width, height, radius); }
+
+        /** Forget every mask, e.g. for a new floor. */
+        void reset(std::size_t width, std::size_t height, std::size_t radius);
+
+        /** Compute every mask up front instead of on first use. */
+        void build(const BitGrid &solid_map);
+
+        /** (x, y) changed opacity: forget the masks of every origin that can see it. */
+        void cell_changed(std::size_t x, std::size_t y);
+
+        mask_t mask(const BitGrid &solid_map, std::size_t origin_x, std::size_t origin_y)
+        {
+            const std::size_t idx = origin_y * width_ + origin_x;
+            if (!known_.at(origin_x, origin_y))
+            {
+                masks_[idx] = compute(solid_map, origin_x, origin_y);
+                known_.set(origin_x, origin_y);
+            }
+            return masks_[idx];
+        }
+
+        /** Same contract as ShadowCast::cast() with this table's radius, every cell visited once. */
+        template <typename Visit>
+        void cast(const BitGrid &solid_map, std::size_t origin_x, std::size_t origin_y,
+                  Workspace &ws, Visit &&visit)
+        {
+            const std::size_t side = 2 * radius_ + 1;
+            Window &window = ws.window;
+            window.min_x = origin_x - std::min(origin_x, radius_);
+            window.min_y = origin_y - std::min(origin_y, radius_);
+            window.max_x = std::min(width_, origin_x + radius_ + 1);
+            window.max_y = std::min(height_, origin_y + radius_ + 1);
+
+            // Bit (dy + radius) * side + (dx + radius) is the cell at (origin + dx, origin + dy)
+            for (mask_t bits = mask(solid_map, origin_x, origin_y); bits; bits &= bits - 1)
+            {
+                const std::size_t bit = __builtin_ctzll(bits);
+                visit(origin_x + bit % side - radius_, origin_y + bit / side - radius_);
+            }
+        }
+
+        std::size_t radius() const { return radius_; }
+        std::size_t computed() const { return computed_; } /**< Masks computed so far */
+
+    private:
+        mask_t compute(const BitGrid &solid_map, std::size_t origin_x, std::size_t origin_y);
+
+        std::size_t width_ = 0, height_ = 0, radius_ = 0;
+        std::vector<mask_t> masks_;
+        BitGrid known_{0, 0};
+        Workspace ws_;
+        std::size_t computed_ = 0;
+    };
 
     /**
      * @details This implementation is based on the Python shadowcasting algorithm described in
-     * https://www.roguebasin.com/index.php/Python_shadowcasting_implementation.
+     * https://www.roguebasin.com/index.php/Python_shadowcasting_implementation, with the
+     * recursion replaced by an explicit stack and float slopes by exact fractions.
      */
     void update_lightmap(
-        const Grid<unsigned char> &solid_map,
+        const BitGrid &solid_map,
         Lightmap &visible,
         std::size_t origin_x,
         std::size_t origin_y,
         std::size_t radius);
 
+    /**
+     * Same result, but only touches the (2 * radius + 1)^2 windows around the old and new
+     * origin. `visible` must have been all false before the first update with `ws`, and
+     * written by nothing else since.
+     */
+    void update_lightmap(
+        const BitGrid &solid_map,
+        Lightmap &visible,
+        std::size_t origin_x,
+        std::size_t origin_y,
+        std::size_t radius,
+        Workspace &ws);
+
     Lightmap solve_lightmap(
-        const Grid<unsigned char> &solid_map,
+        const BitGrid &solid_map,
         std::size_t origin_x,
         std::size_t origin_y,
         std::size_t radius);
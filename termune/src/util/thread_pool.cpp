@@ -0,0 +1,85 @@
+#include "util/thread_pool.hpp"
+
+#include <algorithm>
+
+void ThreadPool::resize(std::size_t workers)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    start_.notify_all();
+    for (std::thread &t : threads_)
+        t.join();
+    threads_.clear();
+
+    stop_ = false;
+    for (std::size_t i = 0; i < workers; ++i)
+        threads_.emplace_back(&ThreadPool::work, this, job_);
+}
+
+std::size_t ThreadPool::spare_threads()
+{
+    const unsigned int hardware = std::thread::hardware_concurrency(); // 0 when unknown
+    return hardware > 1 ? hardware - 1 : 0;
+}
+
+void ThreadPool::parallel_for(std::size_t count, std::size_t grain, const Task &task)
+{
+    grain = std::max<std::size_t>(grain, 1);
+    if (threads_.empty() || count <= grain)
+    {
+        if (count > 0)
+            task(0, count);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = &task;
+        count_ = count;
+        grain_ = grain;
+        next_ = 0;
+        busy_ = threads_.size();
+        ++job_;
+    }
+    start_.notify_all();
+
+    run_chunks();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [&]
+               { return busy_ == 0; });
+    task_ = nullptr;
+}
+
+void ThreadPool::work(unsigned long seen)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+        start_.wait(lock, [&]
+                    { return stop_ || job_ != seen; });
+        if (stop_)
+            return;
+        seen = job_;
+
+        lock.unlock();
+        run_chunks();
+        lock.lock();
+
+        if (--busy_ == 0)
+            done_.notify_one();
+    }
+}
+
+void ThreadPool::run_chunks()
+{
+    while (true)
+    {
+        const std::size_t begin = next_.fetch_add(grain_);
+        if (begin >= count_)
+            return;
+        (*task_)(begin, std::min(count_, begin + grain_));
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <cstddef>
+#include <functional>
+#include <condition_variable>
+
+/**
+ * A fixed set of worker threads for splitting a loop over an index range. The calling thread
+ * takes chunks too and parallel_for() returns once every chunk is done, so with no workers
+ * (one hardware thread) it is just a plain loop. Tasks must not throw.
+ */
+class ThreadPool
+{
+public:
+    using Task = std::function<void(std::size_t begin, std::size_t end)>;
+
+    /** `workers` threads besides the caller. */
+    explicit ThreadPool(std::size_t workers = 0) { resize(workers); }
+    ~ThreadPool() { resize(0); }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    void resize(std::size_t workers);
+    std::size_t workers() const { return threads_.size(); }
+
+    /** Hardware threads left over besides the caller's. */
+    static std::size_t spare_threads();
+
+    /** task(begin, end) over [0, count) in chunks of `grain`, in no particular order. */
+    void parallel_for(std::size_t count, std::size_t grain, const Task &task);
+
+private:
+    void work(unsigned long seen); // `seen`: the last job before it started
+    void run_chunks();
+
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable start_, done_;
+    unsigned long job_ = 0; // bumped for every parallel_for, which wakes the workers
+    std::size_t busy_ = 0;  // workers not done with the current job
+    bool stop_ = false;
+
+    // The current job, set before the workers are woken
+    const Task *task_ = nullptr;
+    std::size_t count_ = 0, grain_ = 1;
+    std::atomic<std::size_t> next_{0};
+};
@@ -0,0 +1,290 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+#include "types.hpp"
+
+/**
+ * A hierarchical timing wheel with the same interface as EventQueue. Level 0 has a bucket per
+ * tick, each level above a bucket per 256 ticks of the one below. An event goes in the lowest
+ * level whose bucket covers both its tick and the current one, so its level is the highest
+ * byte in which the two differ. Ticks further out than the top level wait in an overflow list.
+ *
+ * Adding, cancelling and popping are O(1): an event moves down at most once per level on its
+ * way to level 0. Buckets are lists in scheduling order. A bucket is filled by a cascade only
+ * when it first comes into range, before anything could be added to it directly, so equal
+ * ticks still pop in the order they were scheduled.
+ */
+template <typename Actor>
+class TimingWheel
+{
+public:
+    using Handle = uint32_t;
+    static constexpr Handle NO_EVENT = UINT32_MAX;
+
+    struct Event
+    {
+        tick_t tick;
+        Actor *actor;
+        uint8_t kind;
+    };
+
+    Handle add(Actor *actor, uint8_t kind, tick_t delay);
+
+    /** Drops the event if it is still scheduled, and clears the handle. */
+    void cancel(Handle &handle);
+
+    /** Moves a scheduled event to `delay` ticks from now, behind events already due then. */
+    void reschedule(Handle handle, tick_t delay);
+
+    bool scheduled(Handle handle) const
+    {
+        return handle < slots_.size() && slots_[handle].level != NOT_QUEUED;
+    }
+
+    bool empty() const { return size_ == 0; }
+    std::size_t size() const { return size_; }
+
+    /** Removes the earliest event and advances the current tick to it. */
+    Event pop();
+
+    /** The earliest event if it is due at the current tick too, without removing it. */
+    const Event *due_now() const
+    {
+        const uint32_t head = levels_[0].buckets[now_ % SLOTS].head; // level 0 holds this tick only
+        return head != NIL ? &slots_[head].event : nullptr;
+    }
+
+    void flush();
+    tick_t current_tick() const { return now_; }
+
+private:
+    static constexpr std::size_t LEVEL_BITS = 8;
+    static constexpr std::size_t SLOTS = std::size_t(1) << LEVEL_BITS;
+    static constexpr std::size_t LEVELS = 4;
+    static constexpr std::size_t SLOT_WORDS = SLOTS / 64;
+    static constexpr uint8_t OVERFLOW_LEVEL = LEVELS;
+    static constexpr uint8_t NOT_QUEUED = 0xff;
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+    struct Slot
+    {
+        Event event;
+        uint32_t prev, next;
+        uint8_t level; /**< OVERFLOW_LEVEL in the overflow list, NOT_QUEUED when free */
+        uint8_t bucket;
+    };
+
+    struct List
+    {
+        uint32_t head = NIL, tail = NIL;
+    };
+
+    struct Level
+    {
+        List buckets[SLOTS];
+        uint64_t occupied[SLOT_WORDS] = {}; // one bit per non-empty bucket
+    };
+
+    List &list_of(const Slot &slot)
+    {
+        return slot.level == OVERFLOW_LEVEL ? overflow_ : levels_[slot.level].buckets[slot.bucket];
+    }
+
+    void place(Handle handle);
+    void append(List &list, Handle handle);
+    void unlink(Handle handle);
+    void release(Handle handle);
+    void cascade(List list);
+    void advance();
+    static std::size_t next_occupied(const Level &level, std::size_t from);
+
+    Level levels_[LEVELS];
+    List overflow_;
+    std::vector<Slot> slots_;
+    std::vector<Handle> free_;
+    std::size_t size_ = 0;
+    tick_t now_ = 0;
+};
+
+template <typename Actor>
+typename TimingWheel<Actor>::Handle TimingWheel<Actor>::add(Actor *actor, uint8_t kind, tick_t delay)
+{
+    Handle handle;
+    if (!free_.empty())
+    {
+        handle = free_.back();
+        free_.pop_back();
+    }
+    else
+    {
+        handle = static_cast<Handle>(slots_.size());
+        slots_.emplace_back();
+    }
+
+    slots_[handle].event = {now_ + delay, actor, kind};
+    place(handle);
+    ++size_;
+    return handle;
+}
+
+template <typename Actor>
+void TimingWheel<Actor>::cancel(Handle &handle)
+{
+    if (scheduled(handle))
+    {
+        unlink(handle);
+        release(handle);
+    }
+    handle = NO_EVENT;
+}
+
+template <typename Actor>
+void TimingWheel<Actor>::reschedule(Handle handle, tick_t delay)
+{
+    if (!scheduled(handle))
+        return;
+
+    unlink(handle);
+    slots_[handle].event.tick = now_ + delay;
+    place(handle);
+}
+
+template <typename Actor>
+typename TimingWheel<Actor>::Event TimingWheel<Actor>::pop()
+{
+    std::size_t bucket;
+    while ((bucket = next_occupied(levels_[0], now_ % SLOTS)) == SLOTS)
+        advance();
+
+    now_ += bucket - now_ % SLOTS;
+    const Handle handle = levels_[0].buckets[bucket].head;
+    Event event = slots_[handle].event;
+    unlink(handle);
+    release(handle);
+    return event;
+}
+
+template <typename Actor>
+void TimingWheel<Actor>::flush()
+{
+    for (std::size_t i = 0; i < slots_.size(); ++i)
+        if (slots_[i].level != NOT_QUEUED)
+            release(static_cast<Handle>(i));
+    for (Level &level : levels_)
+        level = Level();
+    overflow_ = List();
+}
+
+template <typename Actor>
+void TimingWheel<Actor>::place(Handle handle)
+{
+    Slot &slot = slots_[handle];
+    const tick_t diff = slot.event.tick ^ now_;
+    const std::size_t level = diff ? (63 - __builtin_clzll(diff)) / LEVEL_BITS : 0;
+    if (level >= LEVELS)
+    {
+        slot.level = OVERFLOW_LEVEL;
+        append(overflow_, handle);
+        return;
+    }
+
+    slot.level = static_cast<uint8_t>(level);
+    slot.bucket = static_cast<uint8_t>((slot.event.tick >> (level * LEVEL_BITS)) % SLOTS);
+    levels_[level].occupied[slot.bucket / 64] |= uint64_t(1) << (slot.bucket % 64);
+    append(levels_[level].buckets[slot.bucket], handle);
+}
+
+template <typename Actor>
+void TimingWheel<Actor>::append(List &list, Handle handle)
+{
+    Slot &slot = slots_[handle];
+    slot.prev = list.tail;
+    slot.next = NIL;
+    if (list.tail != NIL)
+        slots_[list.tail].next = handle;
+    else
+        list.head = handle;
+    list.tail = handle;
+}
+
+template <typename Actor>
+void TimingWheel<Actor>::unlink(Handle handle)
+{
+    Slot &slot = slots_[handle];
+    List &list = list_of(slot);
+    (slot.prev != NIL ? slots_[slot.prev].next : list.head) = slot.next;
+    (slot.next != NIL ? slots_[slot.next].prev : list.tail) = slot.prev;
+
+    if (list.head == NIL && slot.level != OVERFLOW_LEVEL)
+        levels_[slot.level].occupied[slot.bucket / 64] &= ~(uint64_t(1) << (slot.bucket % 64));
+}
+
+template <typename Actor>
+void TimingWheel<Actor>::release(Handle handle)
+{
+    slots_[handle].level = NOT_QUEUED;
+    free_.push_back(handle);
+    --size_;
+}
+
+template <typename Actor>
+void TimingWheel<Actor>::cascade(List list)
+{
+    // Walks the detached list front to back, so the events keep their order in lower levels
+    for (uint32_t handle = list.head; handle != NIL;)
+    {
+        const uint32_t next = slots_[handle].next;
+        place(handle);
+        handle = next;
+    }
+}
+
+template <typename Actor>
+void TimingWheel<Actor>::advance()
+{
+    // Level 0 is empty from now on: jump to the next bucket in use above it and bring it down
+    for (std::size_t level = 1; level < LEVELS; ++level)
+    {
+        const std::size_t shift = level * LEVEL_BITS;
+        const std::size_t bucket = next_occupied(levels_[level], (now_ >> shift) % SLOTS);
+        if (bucket == SLOTS)
+            continue;
+
+        now_ = ((now_ >> shift >> LEVEL_BITS << LEVEL_BITS) + bucket) << shift;
+        Level &from = levels_[level];
+        const List list = from.buckets[bucket];
+        from.buckets[bucket] = List();
+        from.occupied[bucket / 64] &= ~(uint64_t(1) << (bucket % 64));
+        cascade(list);
+        return;
+    }
+
+    // Only the overflow list is left: jump to the earliest stretch of it that fits the wheel
+    const std::size_t shift = LEVELS * LEVEL_BITS;
+    tick_t start = ~tick_t(0);
+    for (uint32_t handle = overflow_.head; handle != NIL; handle = slots_[handle].next)
+        start = std::min(start, slots_[handle].event.tick >> shift);
+    now_ = start << shift;
+
+    const List list = overflow_;
+    overflow_ = List();
+    cascade(list); // whatever is still too far goes back to the overflow list, in order
+}
+
+template <typename Actor>
+std::size_t TimingWheel<Actor>::next_occupied(const Level &level, std::size_t from)
+{
+    std::size_t word = from / 64;
+    uint64_t bits = level.occupied[word] & (~uint64_t(0) << (from % 64));
+    while (!bits)
+    {
+        if (++word == SLOT_WORDS)
+            return SLOTS;
+        bits = level.occupied[word];
+    }
+    return word * 64 + __builtin_ctzll(bits);
+}